@@ -0,0 +1,68 @@
+/**
+ * @file attitude.h
+ * @brief Mahony attitude filter and self-calibrated mounting rotation into the vehicle frame.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_ATTITUDE_H_
+#define INC_ATTITUDE_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "imu_ring.h"
+#include "imu_filter.h"
+
+/**
+ * User defined Macros
+ */
+#define ATTITUDE_FORWARD_AXIS	(1)		// sensor axis closest to the direction of travel, Y
+#define ATTITUDE_FORWARD_SIGN	(1)		// -1 when the unit faces backwards
+#define ATTITUDE_CALIB_SAMPLES	(3000)	// qualifying 100 Hz samples per mounting estimate, 30 s
+
+/**
+ * @brief Motion in the vehicle frame: forward, left, up.
+ */
+typedef struct {
+    int32_t lon_mg;      /**< Longitudinal acceleration, positive forward. */
+    int32_t lat_mg;      /**< Lateral acceleration, positive to the left. */
+    int32_t vert_mg;     /**< Vertical acceleration with gravity removed, positive up. */
+    int32_t yaw_mdps;    /**< Rate about the vertical, positive turning left. */
+} VEHICLEMOTION;
+
+/**
+ * @brief Filter and calibration state for the debugger and logs.
+ */
+typedef struct {
+    float tilt_deg;            /**< Angle between the sensor Z axis and the vertical. */
+    float mount_yaw_deg;       /**< Forward direction from the configured sensor axis. */
+    uint8_t gyro_valid;        /**< 1 once the gyro offset was measured at rest. */
+    uint8_t mount_valid;       /**< 1 once a mounting estimate was made. */
+    uint32_t calib_samples;    /**< Qualifying samples towards the next estimate. */
+    uint32_t calib_updates;    /**< Mounting estimates made. */
+} ATTITUDESTATUS;
+
+#ifdef ATTITUDE_BENCHMARK
+void attitude_benchmark(uint32_t *cycles);
+#endif
+
+/**
+ * User defined functions
+ */
+void attitude_init(void);
+
+void attitude_update(const IMUFRAME *f, VEHICLEMOTION *out);
+
+void attitude_calibrate(const IMUFILTEROUT *s);
+
+void attitude_to_vehicle(const int16_t accel_raw[3], VEHICLEMOTION *out);
+
+void attitude_status(ATTITUDESTATUS *status);
+
+#endif /* INC_ATTITUDE_H_ */
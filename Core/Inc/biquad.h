@@ -0,0 +1,55 @@
+/**
+ * @file biquad.h
+ * @brief Fixed-point direct form I biquad sections and integer decimators.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_BIQUAD_H_
+#define INC_BIQUAD_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+#define BIQUAD_COEF_SHIFT	(30)	// coefficients are Q2.30, |a1| reaches 2 near DC
+#define BIQUAD_SIG_SHIFT	(8)		// signals carry 8 fraction bits below one raw count
+#define BIQUAD_FROM_RAW(x)	((int32_t)(x) * (1 << BIQUAD_SIG_SHIFT))
+#define BIQUAD_TO_RAW(x)	((int16_t)(((x) + (1 << (BIQUAD_SIG_SHIFT - 1))) >> BIQUAD_SIG_SHIFT))
+
+/**
+ * @brief One section, y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2, a0 normalised to 1.
+ */
+typedef struct {
+    int32_t b0, b1, b2, a1, a2;
+} BIQUADCOEF;
+
+/**
+ * @brief Delay line of one section, in the BIQUAD_SIG_SHIFT signal format.
+ */
+typedef struct {
+    int32_t x1, x2, y1, y2;
+} BIQUADSTATE;
+
+/**
+ * @brief Keeps one sample out of every factor.
+ */
+typedef struct {
+    uint8_t factor;
+    uint8_t phase;
+} DECIMATOR;
+
+/**
+ * User defined functions
+ */
+void biquad_prime(const BIQUADCOEF *c, BIQUADSTATE *s, uint8_t sections, int32_t x);
+
+int32_t biquad_run(const BIQUADCOEF *c, BIQUADSTATE *s, uint8_t sections, int32_t x);
+
+uint8_t decimator_step(DECIMATOR *d);
+
+#endif /* INC_BIQUAD_H_ */
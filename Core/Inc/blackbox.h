@@ -0,0 +1,84 @@
+/**
+ * @file blackbox.h
+ * @brief Crash recorder keeping seconds of full-rate IMU data around an impact in CCM RAM.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_BLACKBOX_H_
+#define INC_BLACKBOX_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "imu_ring.h"
+
+/**
+ * User defined Macros
+ */
+#define BLACKBOX_BLOCKS			(160)	// 5.12 s of IMU_BLOCK_LEN blocks at 1 kHz, 62 KB of the 64 KB CCM
+#define BLACKBOX_POST_BLOCKS	(32)	// captured after the trigger, 1.02 s
+#define BLACKBOX_TRIGGER_MG		(2500)	// acceleration magnitude of an impact, gravity included
+#define BLACKBOX_WRITE_BLOCKS	(8)		// blocks streamed to the SD card per blackbox_service() call
+
+/**
+ * @brief One recorded block, the samples are 1 ms apart from t_us on.
+ */
+typedef struct {
+    uint32_t t_us;                         /**< TIMESTAMP_US() of the first sample. */
+    int16_t s[IMU_BLOCK_LEN][6];           /**< ax, ay, az, gx, gy, gz raw counts. */
+} BBBLOCK;
+
+/**
+ * @brief File header, followed by the blocks oldest first.
+ */
+typedef struct {
+    char magic[4];             /**< "BBX1". */
+    uint32_t trigger_us;       /**< TIMESTAMP_US() of the triggering sample. */
+    uint32_t trigger_utc_s;    /**< UTC seconds of the trigger, 0 without GPS time. */
+    uint16_t trigger_utc_ms;
+    uint16_t sample_rate_hz;
+    uint16_t block_len;        /**< Samples per block. */
+    uint16_t blocks;           /**< Blocks in the file. */
+    uint16_t trigger_block;    /**< Block holding the triggering sample. */
+    uint16_t peak_mg;          /**< Acceleration magnitude that triggered. */
+} BBHEADER;
+
+/**
+ * @brief Recorder state.
+ */
+typedef enum {
+    BLACKBOX_RECORDING = 0,    /**< Rolling pre-trigger history. */
+    BLACKBOX_POST,             /**< Triggered, capturing the post-trigger blocks. */
+    BLACKBOX_WRITING           /**< Frozen, streaming to the SD card. */
+} BLACKBOXSTATE;
+
+/**
+ * @brief Recorder counters.
+ */
+typedef struct {
+    uint32_t triggers;         /**< Impacts recorded. */
+    uint32_t files;            /**< Recordings completely written. */
+    uint32_t write_errors;     /**< Recordings abandoned on a file system error. */
+    uint32_t skipped_blocks;   /**< Blocks not recorded while a recording was being written. */
+} BLACKBOXSTATS;
+
+/**
+ * User defined functions
+ */
+void blackbox_init(void);
+
+void blackbox_block(const IMUFRAME *block);
+
+void blackbox_service(void);
+
+BLACKBOXSTATE blackbox_state(void);
+
+void blackbox_stats(BLACKBOXSTATS *stats);
+
+#endif /* INC_BLACKBOX_H_ */
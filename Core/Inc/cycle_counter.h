@@ -0,0 +1,26 @@
+/**
+ * @file cycle_counter.h
+ * @brief DWT cycle counter used to measure code paths on the target.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_CYCLE_COUNTER_H_
+#define INC_CYCLE_COUNTER_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include "stm32f4xx.h"
+
+/**
+ * User defined Macros
+ */
+#define CYCLE_COUNTER()		(DWT->CYCCNT)	// core clock cycles, wraps after 2^32
+
+/**
+ * User defined functions
+ */
+void cycle_counter_init(void);
+
+#endif /* INC_CYCLE_COUNTER_H_ */
@@ -0,0 +1,56 @@
+/**
+ * @file dsp_kernels.h
+ * @brief Block reductions over int16 samples using the Cortex-M4 dual 16-bit SIMD instructions.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_DSP_KERNELS_H_
+#define INC_DSP_KERNELS_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined functions
+ * @note n may be 0 except for min/max, sums wrap like the scalar reference past 65535 samples.
+ */
+int32_t dsp_sum_i16(const int16_t *x, uint32_t n);
+
+int64_t dsp_sumsq_i16(const int16_t *x, uint32_t n);
+
+int64_t dsp_dot_i16(const int16_t *a, const int16_t *b, uint32_t n);
+
+int16_t dsp_min_i16(const int16_t *x, uint32_t n);
+
+int16_t dsp_max_i16(const int16_t *x, uint32_t n);
+
+/**
+ * Portable scalar references, the SIMD kernels must match them bit for bit
+ */
+int32_t dsp_sum_i16_ref(const int16_t *x, uint32_t n);
+
+int64_t dsp_sumsq_i16_ref(const int16_t *x, uint32_t n);
+
+int64_t dsp_dot_i16_ref(const int16_t *a, const int16_t *b, uint32_t n);
+
+int16_t dsp_min_i16_ref(const int16_t *x, uint32_t n);
+
+int16_t dsp_max_i16_ref(const int16_t *x, uint32_t n);
+
+#ifdef DSP_BENCHMARK
+/**
+ * @brief Result of dsp_benchmark(), cycles for one second of 3-axis data at 1 kHz.
+ */
+typedef struct {
+    uint32_t mismatches;      /**< Kernel results differing from the scalar reference, must be 0. */
+    uint32_t ref_cycles;      /**< Scalar sum, sum of squares, min and max of every axis. */
+    uint32_t simd_cycles;     /**< The same with the SIMD kernels. */
+} DSPBENCH;
+
+void dsp_benchmark(DSPBENCH *result);
+#endif
+
+#endif /* INC_DSP_KERNELS_H_ */
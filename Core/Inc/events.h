@@ -13,12 +13,25 @@
  */
 #include <stdint.h>
 
+/**
+ * User-defined libraries
+ */
+#include "maneuver.h"
+
 /**
  * User defined functions
  */
-void event_analysis(int16_t *xbuffer, int16_t *ybuffer, int16_t *zbuffer);
+void event_init(void);
+
+void event_update(int16_t lat, int16_t lon, int16_t vert);
+
+uint8_t event_log_due(void);
+
+void event_log(void);
+
+void event_maneuver(const MANEUVER *m);
 
-void buf_analysis(int16_t input_buffer[], int index);
+void buf_analysis(int index);
 
 void goToAscii(int16_t number, char* resBuf);
 
@@ -0,0 +1,29 @@
+/**
+ * @file filter_coeffs.h
+ * @brief Q2.30 biquad coefficients of the IMU filter pipeline.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Generated by Scripts/gen_filter_coeffs.py, edit the script and rerun it instead of this file.
+ */
+
+#ifndef INC_FILTER_COEFFS_H_
+#define INC_FILTER_COEFFS_H_
+
+/**
+ * User-defined libraries
+ */
+#include "biquad.h"
+
+// 1 kHz anti-alias low-pass ahead of the /10 decimation to 100 Hz, Butterworth order 4, 25 Hz at 1000 Hz
+static const BIQUADCOEF filter_aa_1k[] = {
+    { 5775114, 11550228, 5775114, -1853206872, 802565504 },
+    { 6236429, 12472857, 6236429, -2001240540, 952444431 },
+};
+
+// 100 Hz anti-alias low-pass ahead of the /10 decimation to 10 Hz, Butterworth order 4, 3 Hz at 100 Hz
+static const BIQUADCOEF filter_aa_100[] = {
+    { 8106143, 16212284, 8106143, -1798153500, 756836246 },
+    { 8873184, 17746368, 8873184, -1968303260, 930054172 },
+};
+
+#endif /* INC_FILTER_COEFFS_H_ */
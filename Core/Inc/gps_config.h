@@ -0,0 +1,58 @@
+/**
+ * @file gps_config.h
+ * @brief GPS receiver configuration: update rate, baud rate and NMEA sentence output.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_GPS_CONFIG_H_
+#define INC_GPS_CONFIG_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "nmea_tokenizer.h"
+
+/**
+ * User defined Macros
+ */
+#define GPS_CFG_ACK_TIMEOUT_MS	(300)	// receiver answers within one navigation epoch
+#define GPS_CFG_RETRIES			(3)
+
+/**
+ * @brief Receiver settings applied by GPS_configure().
+ */
+typedef struct {
+    uint32_t baud;                       /**< UART baud rate on both ends. */
+    uint16_t meas_period_ms;             /**< Navigation solution period, 200 for 5 Hz, 100 for 10 Hz. */
+    uint8_t nmea_rate[NMEA_TYPE_COUNT];  /**< Output every n-th solution per sentence type, 0 disables it. */
+} GPSCONFIG;
+
+/**
+ * @brief Result of a configuration step.
+ */
+typedef enum {
+    GPS_CFG_OK = 0,     /**< Receiver acknowledged every command. */
+    GPS_CFG_NAK,        /**< Receiver rejected a command. */
+    GPS_CFG_TIMEOUT     /**< No acknowledgement at either baud rate. */
+} GPSCFGSTATUS;
+
+/**
+ * Set while a command waits for its acknowledgement, the USART2 receive path
+ * only hands bytes to gps_config_feed() then
+ */
+extern volatile uint8_t gps_config_listening;
+
+/**
+ * User defined functions
+ */
+GPSCFGSTATUS GPS_configure(const GPSCONFIG *cfg);
+
+void gps_config_feed(const uint8_t *data, uint16_t len);
+
+#endif /* INC_GPS_CONFIG_H_ */
@@ -0,0 +1,49 @@
+/**
+ * @file gps_time.h
+ * @brief UTC time service disciplined by GPS time and date, extrapolated with SysTick.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_GPS_TIME_H_
+#define INC_GPS_TIME_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+#define GPS_UTC_OFFSET_MIN	(-7 * 60)	// local time used for file timestamps, UTC-7 (MST)
+
+/**
+ * @brief Broken-down calendar time.
+ */
+typedef struct {
+    uint16_t year;     /**< Full year, e.g. 2023. */
+    uint8_t month;     /**< 1..12. */
+    uint8_t day;       /**< 1..31. */
+    uint8_t hour;      /**< 0..23. */
+    uint8_t min;       /**< 0..59. */
+    uint8_t sec;       /**< 0..59. */
+    uint16_t msec;     /**< 0..999. */
+} GPSDATETIME;
+
+/**
+ * User defined functions
+ */
+void gps_time_set_date(int year, int month, int day);
+
+void gps_time_set_tod(int32_t tod_ms, uint32_t rx_tick);
+
+uint8_t gps_time_valid(void);
+
+uint64_t gps_time_now_ms(void);
+
+void gps_time_to_civil(uint64_t utc_ms, int32_t offset_min, GPSDATETIME *out);
+
+uint32_t gps_time_fattime(void);
+
+#endif /* INC_GPS_TIME_H_ */
@@ -8,6 +8,11 @@
 #ifndef INC_I2C_H_
 #define INC_I2C_H_
 
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
 /**
  * User defined Macros
  */
@@ -24,10 +29,21 @@
 #define GPIOC_PC9_PULL_UP		(1<<18)
 #define GPIOA_PA8_AFR_I2C3		(4<<0)
 #define GPIOC_PC9_AFR_I2C3		(4<<4)
+#define GPIOA_PA8_MODE_MASK		(3<<16)
+#define GPIOC_PC9_MODE_MASK		(3<<18)
+#define GPIOA_PA8_OUT			(1<<16)
+#define GPIOC_PC9_OUT			(1<<18)
+#define GPIOA_PA8_AFR_MASK		(0xF<<0)
+#define GPIOC_PC9_AFR_MASK		(0xF<<4)
+#define GPIOA_PA8_PIN			(1<<8)
+#define GPIOC_PC9_PIN			(1<<9)
 #define I2C3_SWRESET_SET		(1<<15)
-#define I2C3_PERIPH_FREQ		(24<<0)
-#define I2C3_CCR				(120<<0)
-#define I2C3_TRISE				(25)
+#define I2C3_SPEED_HZ			(400000)	// fast mode, the MPU6050 supports 400 kHz
+#define I2C3_FAST_DUTY			(I2C_DUTY_2)
+#define I2C_STANDARD_MAX_HZ		(100000)
+#define I2C_FAST_MAX_HZ			(400000)
+#define CCR_FS_BIT				(1<<15)
+#define CCR_DUTY_BIT			(1<<14)
 #define I2C3_ENABLE				(1<<0)
 #define ACK_ENABLE				(1<<10)
 #define START_GEN				(1<<8)
@@ -37,17 +53,86 @@
 #define ADDR_BIT				(1<<1)
 #define STOP_BIT				(1<<9)
 #define RXNE_BIT				(1<<6)
+#define BERR_BIT				(1<<8)
+#define ARLO_BIT				(1<<9)
+#define AF_BIT					(1<<10)
+#define OVR_BIT					(1<<11)
+#define ITERREN_BIT				(1<<8)
+#define ITEVTEN_BIT				(1<<9)
+#define ITBUFEN_BIT				(1<<10)
+#define DMAEN_BIT				(1<<11)
+#define LAST_BIT				(1<<12)
+
+#define I2C3_QUEUE_LEN			(16)	// Power of two, outstanding transactions
+#define I2C3_IRQ_PRIORITY		(1)		// above USART2, a late STOP stretches the bus
+#define I2C3_TIMEOUT_SLACK		(4)		// deadline = slack * nominal transfer time + minimum
+#define I2C3_TIMEOUT_MIN_US		(500)
+#define I2C3_STOP_TIMEOUT_US	(100)	// STOP condition takes a few microseconds
+#define I2C3_RECOVERY_CLOCKS	(9)		// enough for a slave to finish any byte it was sending
+#define I2C3_RECOVERY_HALF_US	(5)		// bit-banged SCL at 100 kHz
+
+/**
+ * @brief Fast mode SCL low/high ratio.
+ */
+typedef enum {
+    I2C_DUTY_2 = 0,    /**< Tlow/Thigh = 2, SCL = PCLK1 / (3 * CCR). */
+    I2C_DUTY_16_9,     /**< Tlow/Thigh = 16/9, SCL = PCLK1 / (25 * CCR), needs PCLK1 a multiple of 10 MHz for 400 kHz. */
+} I2CDUTY;
+
+/**
+ * @brief I2C timing register values for one clock setup.
+ */
+typedef struct {
+    uint16_t freq;     /**< CR2 FREQ, PCLK1 in MHz. */
+    uint16_t ccr;      /**< CCR including the F/S and DUTY bits. */
+    uint16_t trise;    /**< TRISE, maximum rise time in PCLK1 cycles + 1. */
+    uint32_t scl_hz;   /**< SCL frequency actually obtained, at most the one asked for. */
+} I2CTIMING;
+
+/**
+ * @brief Completion status of one transaction.
+ */
+typedef enum {
+    I2C_OK = 0,
+    I2C_ERR_NACK,      /**< Address or data not acknowledged. */
+    I2C_ERR_BUS,       /**< Misplaced START/STOP. */
+    I2C_ERR_ARLO,      /**< Arbitration lost. */
+    I2C_ERR_OVR,       /**< Overrun/underrun or DMA transfer error. */
+    I2C_ERR_TIMEOUT,   /**< Transaction deadline passed, bus stuck or slave stretching. */
+} I2CSTATUS;
+
+/**
+ * @brief Failure counters, one per I2CSTATUS error plus bus recoveries.
+ */
+typedef struct {
+    uint32_t nack;
+    uint32_t bus_error;
+    uint32_t arbitration_lost;
+    uint32_t overrun;
+    uint32_t timeout;
+    uint32_t recoveries;   /**< 9-clock SCL recoveries followed by a peripheral reset. */
+} I2CSTATS;
+
+/**
+ * @brief Completion callback, runs in interrupt context.
+ * @param status: I2CSTATUS of the finished transaction.
+ * @param ctx: Pointer given when the transaction was queued.
+ */
+typedef void (*I2CCALLBACK)(I2CSTATUS status, void *ctx);
 
 /**
  * User defined functions
  */
-void I2C_Read (uint8_t Address, uint8_t *buffer, uint8_t size);
-void I2C_Stop (void);
-void I2C_Address (uint8_t Address);
-void I2C_Write (uint8_t data);
-void I2C_Start (void);
 void I2C_Config (void);
-void MPU_Write (uint8_t Address, uint8_t Reg, uint8_t Data);
-void MPU_Read (uint8_t Address, uint8_t Reg, uint8_t *buffer, uint8_t size);
+uint8_t I2C_Timing (uint32_t pclk1, uint32_t speed, I2CDUTY duty, I2CTIMING *timing);
+uint8_t MPU_Write (uint8_t Address, uint8_t Reg, uint8_t Data);
+uint8_t MPU_Read (uint8_t Address, uint8_t Reg, uint8_t *buffer, uint16_t size, I2CCALLBACK done, void *ctx);
+uint8_t I2C_Busy (void);
+I2CSTATUS I2C_Wait (void);
+void I2C_Service (void);
+void I2C_Stats (I2CSTATS *stats);
+void i2c3_ev_call(void);
+void i2c3_er_call(void);
+void dma1_stream2_call(void);
 
 #endif /* INC_I2C_H_ */
@@ -0,0 +1,45 @@
+/**
+ * @file imu_convert.h
+ * @brief Fixed-point conversion of raw MPU6050 counts to calibrated engineering units.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_IMU_CONVERT_H_
+#define INC_IMU_CONVERT_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+#define IMU_Q15_ONE		(32768)		// gain 1.0 in Q15
+#define IMU_AXES		(3)
+
+/**
+ * @brief Per-axis calibration, applied as (raw - offset) * gain.
+ */
+typedef struct {
+    int16_t accel_offset[IMU_AXES];   /**< Zero-g output in raw counts. */
+    int16_t gyro_offset[IMU_AXES];    /**< Zero-rate output in raw counts. */
+    uint16_t accel_gain[IMU_AXES];    /**< Scale trim in Q15, IMU_Q15_ONE for none. */
+    uint16_t gyro_gain[IMU_AXES];     /**< Scale trim in Q15, IMU_Q15_ONE for none. */
+} IMUCAL;
+
+/**
+ * User defined functions
+ */
+void imu_convert_init(uint8_t accel_fs_sel, uint8_t gyro_fs_sel);
+
+void imu_convert_calibrate(const IMUCAL *cal);
+
+void imu_convert_calibration(IMUCAL *cal);
+
+int32_t imu_accel_mg(int16_t raw, uint8_t axis);
+
+int32_t imu_gyro_mdps(int16_t raw, uint8_t axis);
+
+#endif /* INC_IMU_CONVERT_H_ */
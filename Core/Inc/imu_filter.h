@@ -0,0 +1,57 @@
+/**
+ * @file imu_filter.h
+ * @brief Per-axis accelerometer filter and decimation pipeline, 1 kHz -> 100 Hz -> 10 Hz.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_IMU_FILTER_H_
+#define INC_IMU_FILTER_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "imu_ring.h"
+
+/**
+ * User defined Macros
+ */
+#define IMU_FILTER_DECIM		(10)	// each decimator keeps one sample in ten
+#define IMU_STREAM_100HZ		(0x01)	// lp100 was updated
+#define IMU_STREAM_10HZ			(0x02)	// lp10 was updated
+
+/**
+ * @brief Pipeline outputs in raw counts, each stream holds its last value between updates.
+ */
+typedef struct {
+    uint32_t t_us;          /**< Timestamp of the input sample that produced the update. */
+    int16_t lp100[3];       /**< Anti-aliased 100 Hz acceleration, gravity included. */
+    int16_t lp10[3];        /**< Anti-aliased 10 Hz acceleration, gravity included. */
+} IMUFILTEROUT;
+
+#ifdef FILTER_BENCHMARK
+/**
+ * @brief Cycle counts measured by imu_filter_benchmark().
+ */
+typedef struct {
+    uint32_t section_cycles;     /**< One biquad section on one sample. */
+    uint32_t decimator_cycles;   /**< One decimator step. */
+    uint32_t sample_cycles;      /**< Whole pipeline per 1 kHz input sample, averaged. */
+} IMUFILTERBENCH;
+
+void imu_filter_benchmark(IMUFILTERBENCH *result);
+#endif
+
+/**
+ * User defined functions
+ */
+void imu_filter_init(void);
+
+uint8_t imu_filter_push(const IMUFRAME *f, IMUFILTEROUT *out);
+
+#endif /* INC_IMU_FILTER_H_ */
@@ -0,0 +1,59 @@
+/**
+ * @file imu_ring.h
+ * @brief Ring of timestamped 6-DoF samples handed from the acquisition interrupts to the main loop in blocks.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_IMU_RING_H_
+#define INC_IMU_RING_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+#define IMU_RING_LEN		(256)	// Power of two, 256 ms at 1 kHz, three times the sensor FIFO
+#define IMU_BLOCK_LEN		(32)	// Power of two dividing IMU_RING_LEN, samples per handed-over block
+#define IMU_RING_BLOCKS		(IMU_RING_LEN / IMU_BLOCK_LEN)
+
+/**
+ * @brief One packed accelerometer and gyroscope sample, 16 bytes without padding.
+ */
+typedef struct {
+    uint32_t t_us;     /**< TIMESTAMP_US() of the data-ready interrupt. */
+    int16_t ax;
+    int16_t ay;
+    int16_t az;
+    int16_t gx;
+    int16_t gy;
+    int16_t gz;
+} IMUFRAME;
+
+/**
+ * @brief Ring counters.
+ */
+typedef struct {
+    uint32_t frames;     /**< Samples stored. */
+    uint32_t blocks;     /**< Blocks released by the consumer. */
+    uint32_t dropped;    /**< Samples refused because every block was still unreleased. */
+    uint16_t max_fill;   /**< Highest number of samples waiting, in samples. */
+} IMURINGSTATS;
+
+/**
+ * User defined functions
+ */
+IMUFRAME *imu_ring_slot(void);
+
+void imu_ring_commit(void);
+
+const IMUFRAME *imu_ring_block(void);
+
+void imu_ring_release(void);
+
+void imu_ring_stats(IMURINGSTATS *stats);
+
+#endif /* INC_IMU_RING_H_ */
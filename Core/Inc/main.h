@@ -126,15 +126,6 @@ void Error_Handler(void);
 
 /* USER CODE BEGIN Private defines */
 /* USER CODE BEGIN Private defines */
-#define MPU6050_ADDR 0xD0
-#define SMPLRT_DIV_REG 0x19
-#define GYRO_CONFIG_REG 0x1B
-#define ACCEL_CONFIG_REG 0x1C
-#define ACCEL_XOUT_H_REG 0x3B
-#define TEMP_OUT_H_REG 0x41
-#define GYRO_XOUT_H_REG 0x43
-#define PWR_MGMT_1_REG 0x6B
-#define WHO_AM_I_REG 0x75
 #define RCC_GPIOA_ENR   (0001)
 #define RCC_GPIOD_ENR   (0b01 << 3)
 #define GPIOA_PORT0_INPUT  (0b11)
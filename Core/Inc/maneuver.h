@@ -0,0 +1,69 @@
+/**
+ * @file maneuver.h
+ * @brief Streaming harsh braking, acceleration and cornering detector run on every IMU sample.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_MANEUVER_H_
+#define INC_MANEUVER_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "attitude.h"
+
+/**
+ * User defined Macros
+ */
+#define MANEUVER_QUEUE_LEN		(16)	// Power of two, finished events waiting for the main loop
+
+/**
+ * @brief Maneuver kinds.
+ */
+typedef enum {
+    MANEUVER_BRAKE = 0,
+    MANEUVER_ACCEL,
+    MANEUVER_CORNER,
+    MANEUVER_KINDS
+} MANEUVERKIND;
+
+/**
+ * @brief One finished event, 16 bytes.
+ */
+typedef struct {
+    uint32_t start_us;     /**< TIMESTAMP_US() of the sample that entered the event. */
+    uint32_t end_us;       /**< TIMESTAMP_US() of the sample that left it. */
+    uint16_t duration_ms;  /**< end_us - start_us, saturated. */
+    uint16_t peak_mg;      /**< Largest horizontal acceleration magnitude. */
+    uint16_t peak_jerk;    /**< Largest jerk towards the event direction in mg/s, saturated. */
+    uint8_t kind;          /**< MANEUVERKIND. */
+    uint8_t peak_yaw_dps;  /**< Largest yaw rate, saturated at 255 deg/s. */
+} MANEUVER;
+
+/**
+ * @brief Detector counters.
+ */
+typedef struct {
+    uint32_t events[MANEUVER_KINDS];   /**< Events that lasted the minimum duration. */
+    uint32_t rejected;                 /**< Events shorter than the minimum duration. */
+    uint32_t queue_full;               /**< Finished events lost because the main loop fell behind. */
+} MANEUVERSTATS;
+
+/**
+ * User defined functions
+ */
+void maneuver_init(void);
+
+void maneuver_update(uint32_t t_us, const VEHICLEMOTION *m);
+
+uint8_t maneuver_pop(MANEUVER *m);
+
+void maneuver_stats(MANEUVERSTATS *stats);
+
+#endif /* INC_MANEUVER_H_ */
@@ -0,0 +1,89 @@
+/**
+ * @file mpu6050.h
+ * @brief MPU6050 accelerometer/gyroscope driver, hardware FIFO acquisition.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_MPU6050_H_
+#define INC_MPU6050_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+/*Datasheet Value: 0x68*/
+#define MPU6050_ADDR 0xD0
+#define SMPLRT_DIV_REG 0x19
+#define CONFIG_REG 0x1A
+#define GYRO_CONFIG_REG 0x1B
+#define ACCEL_CONFIG_REG 0x1C
+#define FIFO_EN_REG 0x23
+#define INT_ENABLE_REG 0x38
+#define INT_STATUS_REG 0x3A
+#define ACCEL_XOUT_H_REG 0x3B
+#define TEMP_OUT_H_REG 0x41
+#define GYRO_XOUT_H_REG 0x43
+#define GYRO_ZOUT_L_REG 0x48
+#define USER_CTRL_REG 0x6A
+#define PWR_MGMT_1_REG 0x6B
+#define FIFO_COUNTH_REG 0x72
+#define FIFO_R_W_REG 0x74
+#define WHO_AM_I_REG 0x75
+
+#define FIFO_EN_MOTION			(0xF8)	// TEMP, XG, YG, ZG and ACCEL written to the FIFO
+#define USER_CTRL_FIFO_EN		(1<<6)
+#define USER_CTRL_FIFO_RESET	(1<<2)
+#define INT_FIFO_OFLOW			(1<<4)
+#define INT_DATA_RDY			(1<<0)
+
+#define MPU6050_WHO_AM_I		(0x68)
+
+#define MPU6050_FIFO_SIZE		(1024)
+#define MPU6050_FRAME_BYTES		(14)	// ACCEL_XOUT_H..GYRO_ZOUT_L in register order, big-endian
+#define MPU6050_FIFO_MAX_FRAMES	(MPU6050_FIFO_SIZE / MPU6050_FRAME_BYTES)
+#define MPU6050_SAMPLE_RATE_HZ	(1000)	// 1 kHz DLPF output / (1 + SMPLRT_DIV)
+#define MPU6050_ACCEL_FS_SEL	(3)		// +-16 g, 2048 LSB/g
+#define MPU6050_GYRO_FS_SEL		(0)		// +-250 deg/s, 131 LSB/(deg/s)
+#define MPU6050_FS_SEL_SHIFT	(3)		// FS_SEL field position in ACCEL_CONFIG and GYRO_CONFIG
+#define MPU6050_BATCH_FRAMES	(25)	// data-ready interrupts per FIFO burst, 25 ms
+#define MPU6050_STAMP_RING		(1024)	// Power of two, 1 s of data-ready timestamps
+
+/* Sensor INT pin, push-pull active high 50 us pulse, on PB4 / EXTI4 */
+#define MPU6050_INT_PORT		GPIOB
+#define MPU6050_INT_PIN			(4)
+#define MPU6050_INT_EXTICR		(SYSCFG_EXTICR2_EXTI4_PB)
+#define MPU6050_INT_IRQn		EXTI4_IRQn
+
+/**
+ * @brief FIFO acquisition counters.
+ */
+typedef struct {
+    uint32_t frames;     /**< Samples read out of the FIFO. */
+    uint32_t bursts;     /**< Burst reads of FIFO_R_W. */
+    uint32_t overflows;  /**< FIFO overflows, each one drops the FIFO content. */
+    uint32_t data_ready; /**< Data-ready interrupts. */
+} MPUFIFOSTATS;
+
+/**
+ * User defined functions
+ */
+uint8_t MPU6050_Init(void);
+
+int16_t MPU6050_Temperature(void);
+
+uint8_t MPU6050_Read_Range(uint8_t *accel_fs_sel, uint8_t *gyro_fs_sel);
+
+void MPU6050_FIFO_Enable(void);
+
+void MPU6050_DRDY_Init(void);
+
+void MPU6050_FIFO_Stats(MPUFIFOSTATS *stats);
+
+void mpu6050_drdy_call(void);
+
+#endif /* INC_MPU6050_H_ */
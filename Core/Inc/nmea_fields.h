@@ -0,0 +1,38 @@
+/**
+ * @file nmea_fields.h
+ * @brief Typed accessors for the fields of a tokenized NMEA sentence.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_NMEA_FIELDS_H_
+#define INC_NMEA_FIELDS_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "nmea_queue.h"
+
+/**
+ * User defined functions
+ */
+uint8_t nmea_field_len(const NMEASLOT *slot, uint8_t idx);
+
+const char *nmea_field(const NMEASLOT *slot, uint8_t idx);
+
+char nmea_field_char(const NMEASLOT *slot, uint8_t idx);
+
+int32_t nmea_field_int(const NMEASLOT *slot, uint8_t idx);
+
+int nmea_field_2digits(const NMEASLOT *slot, uint8_t idx, uint8_t pos);
+
+int32_t nmea_field_fixed(const NMEASLOT *slot, uint8_t idx, uint8_t frac_digits);
+
+int32_t nmea_field_coord(const NMEASLOT *slot, uint8_t idx);
+
+#endif /* INC_NMEA_FIELDS_H_ */
@@ -0,0 +1,59 @@
+/**
+ * @file nmea_queue.h
+ * @brief Lock-free single-producer/single-consumer queue of received NMEA sentences.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_NMEA_QUEUE_H_
+#define INC_NMEA_QUEUE_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+#define NMEA_QUEUE_SLOTS	(16)	// Must be a power of two, two seconds of default receiver output
+#define NMEA_SENTENCE_MAX	(100)	// NMEA 0183 limits a sentence to 82 characters
+#define NMEA_MAX_FIELDS		(24)	// GSV with four satellites and a signal ID has 21
+
+/**
+ * @brief One completed sentence, written by the USART2 interrupt and read by the main loop.
+ */
+typedef struct {
+    char text[NMEA_SENTENCE_MAX];  /**< Null-terminated sentence without CR/LF. */
+    uint8_t len;                   /**< Number of characters in text. */
+    uint8_t type;                  /**< Sentence type (NMEATYPE) found by the tokenizer. */
+    uint8_t fields;                /**< Number of comma separated fields including the address field. */
+    uint8_t field_start[NMEA_MAX_FIELDS + 1]; /**< Offset of each field in text, one extra entry marks the end of the last field. */
+    uint32_t rx_tick;              /**< SysTick count when the '$' was received. */
+} NMEASLOT;
+
+/**
+ * @brief Queue health counters.
+ */
+typedef struct {
+    uint32_t published;   /**< Sentences handed to the consumer. */
+    uint32_t overflows;   /**< Sentences dropped because every slot was in use. */
+    uint32_t max_depth;   /**< Worst-case number of slots waiting for the consumer. */
+} NMEAQUEUESTATS;
+
+/**
+ * User defined functions
+ */
+NMEASLOT *nmea_queue_claim(void);
+
+void nmea_queue_publish(void);
+
+NMEASLOT *nmea_queue_peek(void);
+
+void nmea_queue_release(void);
+
+uint32_t nmea_queue_depth(void);
+
+void nmea_queue_stats(NMEAQUEUESTATS *stats);
+
+#endif /* INC_NMEA_QUEUE_H_ */
@@ -0,0 +1,48 @@
+/**
+ * @file nmea_tokenizer.h
+ * @brief Byte-at-a-time NMEA 0183 tokenizer feeding the sentence queue.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_NMEA_TOKENIZER_H_
+#define INC_NMEA_TOKENIZER_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * @brief Sentence types recognised by the tokenizer, independent of the talker (GP, GN, GL, ...).
+ */
+typedef enum {
+    NMEA_UNKNOWN = 0,
+    NMEA_GGA,
+    NMEA_RMC,
+    NMEA_GSA,
+    NMEA_GSV,
+    NMEA_VTG,
+    NMEA_GLL,
+    NMEA_TYPE_COUNT
+} NMEATYPE;
+
+/**
+ * @brief Link quality counters kept per sentence type.
+ */
+typedef struct {
+    uint32_t accepted;          /**< Complete sentences with a matching checksum. */
+    uint32_t checksum_failed;   /**< Complete sentences dropped because '*hh' did not match. */
+    uint32_t truncated;         /**< Sentences cut off by a new '$', an early end of line, a bad character or the length limit. */
+} NMEALINKSTATS;
+
+/**
+ * User defined functions
+ */
+void nmea_tokenizer_reset(void);
+
+void nmea_tokenizer_feed(const uint8_t *data, uint16_t len);
+
+void nmea_tokenizer_stats(NMEATYPE type, NMEALINKSTATS *stats);
+
+#endif /* INC_NMEA_TOKENIZER_H_ */
@@ -8,26 +8,37 @@
 #ifndef INC_PARSE_NMEA_H_
 #define INC_PARSE_NMEA_H_
 
+/**
+ * User-defined libraries
+ */
+#include <stdint.h>
+#include "nmea_queue.h"
+
 /**
  * User defined Macros
  */
-#define GMT  (500)
+#define GPS_MAX_SATS			(24)	// satellite table entries, 6 GSV messages of 4
+#define GPS_MAX_USED			(12)	// PRN slots in one GSA sentence
+#define GPS_QUALITY_MAX_HDOP	(500)	// HDOP * 100 above which a fix is not logged
+#define GPS_QUALITY_MIN_SATS	(4)		// satellites used below which a fix is not logged
+#define GPS_QUALITY_STRONG_SNR	(30)	// dB-Hz counted as a strong signal
 
 /**
  * @brief Structure to store parsed GGA (Global Positioning System Fix Data) information.
  */
 typedef struct {
-    float latitude;   /**< Latitude information. */
+    int32_t latitude;  /**< Latitude in degrees * 1e7, south negative. */
     char NS;           /**< North/South indicator. */
-    float longitude;  /**< Longitude information. */
+    int32_t longitude; /**< Longitude in degrees * 1e7, west negative. */
     char EW;           /**< East/West indicator. */
-    int hour;          /**< Hour information. */
-    int min;           /**< Minute information. */
-    int sec;           /**< Second information. */
+    int hour;          /**< UTC hour. */
+    int min;           /**< UTC minute. */
+    int sec;           /**< UTC second. */
     int fixbit_gga;    /**< Fix status indicator. */
-    float altitude;    /**< Altitude information. */
+    int32_t altitude;  /**< Altitude above mean sea level in centimetres. */
     char unit;         /**< Unit of altitude measurement. */
     int numofsat;      /**< Number of satellites used in the fix. */
+    uint16_t hdop;     /**< Horizontal DOP * 100. */
 } GGASTRUCT;
 
 /**
@@ -37,31 +48,128 @@ typedef struct {
     int Day;           /**< Day information. */
     int Mon;           /**< Month information. */
     int Yr;            /**< Year information. */
-    float speed;       /**< Speed information. */
-    float course;      /**< Course information. */
+    int32_t speed;     /**< Speed over ground in milli-knots. */
+    int32_t course;    /**< Course over ground in centidegrees. */
     int fixbit_rmc;    /**< Fix status indicator. */
 } RMCSTRUCT;
 
 /**
- * @brief Structure to store combined GPS data with both GGA and RMC information.
+ * @brief Structure to store parsed GSA (DOP and active satellites) information.
+ */
+typedef struct {
+    uint8_t mode;                      /**< 1 no fix, 2 2D fix, 3 3D fix. */
+    uint8_t num_used;                  /**< Entries in used_prn. */
+    uint8_t used_prn[GPS_MAX_USED];    /**< PRNs used in the navigation solution. */
+    uint16_t pdop;                     /**< Position DOP * 100. */
+    uint16_t hdop;                     /**< Horizontal DOP * 100. */
+    uint16_t vdop;                     /**< Vertical DOP * 100. */
+} GSASTRUCT;
+
+/**
+ * @brief One satellite in view, as reported by GSV.
+ */
+typedef struct {
+    uint8_t prn;       /**< Satellite ID. */
+    uint8_t snr;       /**< Carrier to noise ratio in dB-Hz, 0 when not tracked. */
+    int8_t elevation;  /**< Elevation in degrees. */
+    uint8_t talker;    /**< Second talker character ('P' for GP, 'L' for GL, ...) of the GSV group. */
+    uint16_t azimuth;  /**< Azimuth in degrees. */
+} SATSTRUCT;
+
+/**
+ * @brief Structure to store the satellite table built from GSV messages.
+ */
+typedef struct {
+    uint8_t in_view;                   /**< Satellites in view reported by the latest GSV group. */
+    uint8_t count;                     /**< Valid entries in sat. */
+    SATSTRUCT sat[GPS_MAX_SATS];       /**< Satellite table. */
+} GSVSTRUCT;
+
+/**
+ * @brief Structure to store parsed VTG (course and speed over ground) information.
+ */
+typedef struct {
+    int32_t course;    /**< Course over ground (true) in centidegrees. */
+    int32_t speed;     /**< Speed over ground in milli-knots. */
+    int32_t speed_kph; /**< Speed over ground in metres per hour (km/h * 1000). */
+    char mode;         /**< Positioning mode, 'N' when not valid. */
+} VTGSTRUCT;
+
+/**
+ * @brief Structure to store parsed GLL (geographic position) information.
+ */
+typedef struct {
+    int32_t latitude;  /**< Latitude in degrees * 1e7, south negative. */
+    int32_t longitude; /**< Longitude in degrees * 1e7, west negative. */
+    int hour;          /**< UTC hour. */
+    int min;           /**< UTC minute. */
+    int sec;           /**< UTC second. */
+    int fixbit_gll;    /**< 1 when the status field is 'A'. */
+} GLLSTRUCT;
+
+/**
+ * @brief Per-second fix quality summary, computed from the GSA and GSV tables.
+ */
+typedef struct {
+    uint8_t fix_mode;      /**< GSA fix mode. */
+    uint8_t sats_used;     /**< Satellites used in the solution. */
+    uint8_t sats_in_view;  /**< Satellites in the GSV table, all talkers. */
+    uint8_t sats_strong;   /**< Satellites at or above GPS_QUALITY_STRONG_SNR. */
+    uint8_t mean_snr;      /**< Mean SNR of the satellites used, dB-Hz. */
+    uint8_t good;          /**< 1 if the fix passes the GPS_QUALITY_* limits. */
+    uint16_t pdop;         /**< Position DOP * 100. */
+    uint16_t hdop;         /**< Horizontal DOP * 100. */
+    uint16_t vdop;         /**< Vertical DOP * 100. */
+} GPSQUALITY;
+
+/**
+ * @brief Structure to store combined GPS data from all parsed sentences.
  */
 typedef struct {
     GGASTRUCT GGA;     /**< GGA information. */
     RMCSTRUCT RMC;     /**< RMC information. */
+    GSASTRUCT GSA;     /**< GSA information. */
+    GSVSTRUCT GSV;     /**< Satellite table. */
+    VTGSTRUCT VTG;     /**< VTG information. */
+    GLLSTRUCT GLL;     /**< GLL information. */
+    GPSQUALITY quality; /**< Latest quality summary. */
 } GPSSTRUCT;
 
 
+/**
+ * GPS struct instance, updated by NMEA_process()
+ */
+extern GPSSTRUCT gnssTransfer;
+
 /**
  * User defined functions
  */
-void GGA_analysis(char *input_buffer, GGASTRUCT *gga_input);
+void NMEA_process(void);
+
+void GGA_analysis(const NMEASLOT *slot, GGASTRUCT *gga_input);
+
+void RMC_analysis(const NMEASLOT *slot, RMCSTRUCT *rmc_input);
+
+void GSA_analysis(const NMEASLOT *slot, GSASTRUCT *gsa);
+
+int GSV_analysis(const NMEASLOT *slot, GSVSTRUCT *gsv);
 
-void RMC_analysis(char *input_buffer, RMCSTRUCT *rmc_input);
+void VTG_analysis(const NMEASLOT *slot, VTGSTRUCT *vtg);
 
-int gps_fix_check(char *input_buffer);
+void GLL_analysis(const NMEASLOT *slot, GLLSTRUCT *gll);
 
-int valid_data_check(char *input_buffer);
+void GPS_quality_update(GPSSTRUCT *gps);
+
+#ifdef NMEA_BENCHMARK
+/**
+ * @brief Cycle counts measured by NMEA_benchmark(), averaged per sentence.
+ */
+typedef struct {
+    uint32_t legacy_cycles;   /**< atoi + pow + float decoding of the original parser. */
+    uint32_t fixed_cycles;    /**< Fixed-point field decoding. */
+} NMEABENCH;
 
-int speed_data_check(char *input_buffer);
+void NMEA_benchmark(NMEABENCH *result);
+#endif
 
 #endif /* INC_PARSE_NMEA_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file sensor_registry.h
+ * @brief Registry of I2C3 sensor drivers and scheduler for their periodic burst reads.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_SENSOR_REGISTRY_H_
+#define INC_SENSOR_REGISTRY_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+#define SENSOR_MAX			(4)		// drivers sharing I2C3
+#define SENSOR_READ_MAX		(32)	// largest periodic burst read
+
+/**
+ * @brief One register write of an init sequence.
+ */
+typedef struct {
+    uint8_t reg;
+    uint8_t value;
+} SENSORREG;
+
+/**
+ * @brief Decoder for a completed periodic read, runs in the main loop.
+ * @param data: Bytes read starting at read_reg.
+ * @param len: read_len.
+ */
+typedef void (*SENSORDATA)(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Everything the scheduler needs to know about a sensor.
+ */
+typedef struct {
+    const char *name;
+    uint8_t address;            /**< 8-bit write address. */
+    uint8_t id_reg;             /**< Identity register checked before init. */
+    uint8_t id_value;           /**< Expected identity. */
+    const SENSORREG *init;      /**< Register writes applied in order. */
+    uint8_t init_len;
+    uint8_t read_reg;           /**< First register of the periodic burst. */
+    uint8_t read_len;           /**< Burst length, at most SENSOR_READ_MAX. */
+    uint16_t period_ms;         /**< Burst period, 0 for sensors read by their own path. */
+    SENSORDATA on_data;
+} SENSORDRIVER;
+
+/**
+ * @brief Per-sensor counters.
+ */
+typedef struct {
+    uint8_t present;            /**< Identity matched and init sequence written. */
+    uint32_t reads;             /**< Bursts delivered. */
+    uint32_t missed;            /**< Periods skipped because the previous burst had not finished. */
+    uint32_t errors;            /**< Bursts that failed on the bus. */
+} SENSORSTATS;
+
+/**
+ * User defined functions
+ */
+int8_t sensor_register(const SENSORDRIVER *driver);
+
+uint8_t sensor_init(int8_t handle);
+
+void sensor_poll(void);
+
+void sensor_stats(int8_t handle, SENSORSTATS *stats);
+
+#endif /* INC_SENSOR_REGISTRY_H_ */
@@ -22,4 +22,6 @@ void incr_ticks(void);
 
 void reset_ticks(void);
 
+uint64_t get_ticks(void);
+
 #endif /* INC_SYSTICK_H_ */
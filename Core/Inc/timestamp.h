@@ -0,0 +1,26 @@
+/**
+ * @file timestamp.h
+ * @brief Free-running TIM2 microsecond counter used to timestamp sensor samples.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_TIMESTAMP_H_
+#define INC_TIMESTAMP_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include "stm32f4xx.h"
+
+/**
+ * User defined Macros
+ */
+#define TIMESTAMP_US()		(TIM2->CNT)	// microseconds, 32-bit, wraps after 71 minutes
+
+/**
+ * User defined functions
+ */
+void timestamp_init(void);
+
+#endif /* INC_TIMESTAMP_H_ */
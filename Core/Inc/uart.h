@@ -8,17 +8,44 @@
 #ifndef INC_UART_H_
 #define INC_UART_H_
 
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+#define UART2_RX_DMA_BUF_SIZE	(512)	// Circular DMA buffer, about half a second of 9600 baud output
+#define UART2_DEFAULT_BAUD		(9600)	// GPS receiver factory setting
+#define UART2_TX_BUF_SIZE		(256)	// Power of two, TX queue drained by the TXE interrupt
+
 /**
  * User defined functions
  */
 void Uart2Config (void);
 
+void Uart2SetBaud (uint32_t baud);
+
+uint16_t UART2_Write (const uint8_t *data, uint16_t len);
+
+void UART2_Flush (void);
+
 void UART2_SendChar (char c);
 
 char UART2_GetChar (void);
 
 void UART2_SendString (char *string);
 
+void UART2_SendBuffer (const uint8_t *data, uint16_t len);
+
 void usart2_call(void);
 
+void dma1_stream5_call(void);
+
+/**
+ * Bytes dropped by UART2_Write() because the TX queue was full
+ */
+extern volatile uint32_t uart2_tx_dropped;
+
 #endif /* INC_UART_H_ */
@@ -0,0 +1,56 @@
+/**
+ * @file window_stats.h
+ * @brief O(1) sliding-window sum, mean, min, max and variance of int16 samples.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef INC_WINDOW_STATS_H_
+#define INC_WINDOW_STATS_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User defined Macros
+ */
+#define WINSTATS_MAX_LEN	(64)	// Power of two, longest window
+#define WINSTATS_RESYNC		(64)	// windows between exact recomputations of the variance
+
+/**
+ * @brief Sliding window over the last len samples.
+ * @note min/max use monotonic deques of sample sequence numbers, the values stay in buf
+ *       for as long as their sample is inside the window.
+ */
+typedef struct {
+    int16_t buf[WINSTATS_MAX_LEN];     /**< Last len samples, indexed by sequence number. */
+    uint32_t minq[WINSTATS_MAX_LEN];   /**< Sequence numbers with increasing values. */
+    uint32_t maxq[WINSTATS_MAX_LEN];   /**< Sequence numbers with decreasing values. */
+    uint32_t min_head, min_tail;
+    uint32_t max_head, max_tail;
+    uint32_t seq;                      /**< Samples pushed so far. */
+    uint16_t len;                      /**< Window length. */
+    uint16_t count;                    /**< Samples currently in the window. */
+    int32_t sum;
+    float mean;                        /**< Welford running mean. */
+    float m2;                          /**< Welford sum of squared deviations. */
+} WINSTATS;
+
+/**
+ * User defined functions
+ */
+void winstats_init(WINSTATS *w, uint16_t len);
+
+void winstats_push(WINSTATS *w, int16_t x);
+
+int16_t winstats_min(const WINSTATS *w);
+
+int16_t winstats_max(const WINSTATS *w);
+
+int16_t winstats_mean(const WINSTATS *w);
+
+float winstats_variance(const WINSTATS *w);
+
+#endif /* INC_WINDOW_STATS_H_ */
@@ -0,0 +1,469 @@
+/**
+ * @file attitude.c
+ * @brief Mahony attitude filter and self-calibrated mounting rotation into the vehicle frame.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note The Mahony filter integrates the gyro into a sensor-to-earth quaternion at the
+ * full sample rate and pulls it towards the measured gravity direction with a PI
+ * correction, the integral term tracking what is left of the gyro bias. The zero-rate
+ * offset itself is measured once the unit has been still for REST_SAMPLES after
+ * start-up, installed with imu_convert_calibrate(), and the estimate re-levelled.
+ * The correction is weak and only applied while the accelerometer reads close to 1 g
+ * and the vehicle is not turning. Beyond 3 degrees of disagreement it is capped at
+ * what 3 degrees give, so sustained braking, acceleration and cornering barely tilt
+ * the estimate while real drift is still pulled back. A disagreement that lasts
+ * ERR_HOLD_S is no manoeuvre, the estimate then restarts from the accelerometer.
+ * From the quaternion comes the up axis in sensor coordinates. Forward is the
+ * calibrated forward direction projected onto the horizontal plane, left completes
+ * the right-handed frame, so the result does not depend on how the unit is tilted
+ * in its bracket.
+ * Mounting yaw is learnt from the 100 Hz low-passed stream while driving straight
+ * (little yaw rate) and level (little vertical acceleration). Then horizontal
+ * acceleration is purely longitudinal, so its principal axis over
+ * ATTITUDE_CALIB_SAMPLES is the forward direction, the sign taken closest to the
+ * configured ATTITUDE_FORWARD_AXIS. Until the first estimate that axis is used.
+ * Single precision throughout for the M4F FPU, about 160 floating point operations
+ * and two square roots per sample.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * User-defined libraries
+ */
+#include "attitude.h"
+#include "imu_convert.h"
+
+/**
+ * User defined Macros
+ */
+#define KP				(0.1f)		// proportional gain, about 10 s to follow a tilt change
+#define KI				(0.005f)	// integral gain, remaining gyro bias, damping about 0.7 with KP
+#define ACC_GATE_LO		(900.0f)	// mg, correction only while |a| is close to 1 g
+#define ACC_GATE_HI		(1100.0f)
+#define ERR_GATE		(0.05f)		// sin of 3 deg, larger disagreement is mostly vehicle motion
+#define ERR_HOLD_S		(10.0f)		// s of larger disagreement before re-levelling
+#define REST_SAMPLES	(2000)		// still samples averaged for the gyro offset, 2 s
+#define REST_GYRO_SPREAD	(1000.0f)	// mdps, rate change that means the unit is moving
+#define REST_ACC_SPREAD		(50.0f)		// mg
+#define REST_OFFSET_MAX		(20000.0f)	// mdps, zero-rate tolerance of the MPU6050, above is turning
+#define DT_NOMINAL		(0.001f)	// s at MPU6050_SAMPLE_RATE_HZ
+#define DT_MAX_US		(10000)		// larger gaps are lost samples, integrate one nominal step
+#define MDPS_TO_RADPS	(3.14159265f / 180000.0f)
+#define RAD_TO_DEG		(57.2957795f)
+#define CAL_YAW_MAX		(3000.0f)	// mdps, straight driving
+#define CAL_VERT_MAX	(50.0f)		// mg, level driving
+#define CAL_HORIZ_MIN	(50.0f)		// mg, clear longitudinal acceleration or braking
+#define CAL_HORIZ_MAX	(400.0f)	// mg, beyond that it is hardly straight driving
+#define YAW_SMOOTH		(0.01f)		// 100 ms smoothing of the yaw rate the calibration looks at
+
+/**
+ * User defined variables
+ */
+static float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;   // sensor to earth
+static float bias[3];                                      // integral term, rad/s
+static float up[3] = { 0.0f, 0.0f, 1.0f };                 // vertical in sensor coordinates
+static float fwd_cfg[3];                                   // configured forward axis
+static float fwd[3];                                       // calibrated forward, not yet horizontal
+static float yaw_abs_smooth = 0.0f;                        // mdps
+static uint32_t last_us;
+static uint8_t started = 0;
+static float err_hold = 0.0f;                              // s of disagreement above ERR_GATE
+static int16_t rest_ref[6];                                // first sample of the rest window
+static int32_t rest_sum[6];                                // ax, ay, az, gx, gy, gz raw sums
+static uint16_t rest_count = 0;
+static float spp, spq, sqq;                                // horizontal covariance sums
+static ATTITUDESTATUS att_status;
+
+/**
+ * @brief Converts an accelerometer reading to milli-g floats.
+ * @param raw: ax, ay, az raw counts.
+ * @param a: Acceleration in mg.
+ */
+static void accel_mg(const int16_t *raw, float a[3])
+{
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        a[i] = (float)imu_accel_mg(raw[i], i);
+    }
+}
+
+/**
+ * @brief Recomputes the up axis from the quaternion, third row of the rotation matrix.
+ */
+static void attitude_up(void)
+{
+    up[0] = 2.0f * (q1 * q3 - q0 * q2);
+    up[1] = 2.0f * (q2 * q3 + q0 * q1);
+    up[2] = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+}
+
+/**
+ * @brief Starts the quaternion level with the measured gravity, so the filter needs no convergence time.
+ * @param a: Acceleration, any unit.
+ */
+static void attitude_level(const float a[3])
+{
+    float roll = atan2f(a[1], a[2]);
+    float pitch = atan2f(-a[0], sqrtf(a[1] * a[1] + a[2] * a[2]));
+    float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+    float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+
+    q0 = cr * cp;
+    q1 = sr * cp;
+    q2 = cr * sp;
+    q3 = -sr * sp;
+    attitude_up();
+}
+
+/**
+ * @brief Builds the horizontal forward and left axes around the current up axis.
+ * @param base: Forward direction to project.
+ * @param f: Unit forward.
+ * @param l: Unit left, up x forward.
+ */
+static void attitude_basis(const float base[3], float f[3], float l[3])
+{
+    float d = base[0] * up[0] + base[1] * up[1] + base[2] * up[2];
+    float n;
+
+    f[0] = base[0] - d * up[0];
+    f[1] = base[1] - d * up[1];
+    f[2] = base[2] - d * up[2];
+    n = sqrtf(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+    if (n < 1e-3f)
+    {
+        n = 1e-3f;   // forward axis mounted vertical, the frame is meaningless but stays finite
+    }
+    f[0] /= n;
+    f[1] /= n;
+    f[2] /= n;
+    l[0] = up[1] * f[2] - up[2] * f[1];
+    l[1] = up[2] * f[0] - up[0] * f[2];
+    l[2] = up[0] * f[1] - up[1] * f[0];
+}
+
+/**
+ * @brief Projects an acceleration onto the vehicle frame.
+ * @param a: Acceleration in mg, sensor coordinates.
+ * @param out: Receives lon_mg, lat_mg and vert_mg, yaw_mdps is left untouched.
+ */
+static void attitude_project(const float a[3], VEHICLEMOTION *out)
+{
+    float f[3], l[3];
+
+    attitude_basis(fwd, f, l);
+    out->lon_mg = (int32_t)(a[0] * f[0] + a[1] * f[1] + a[2] * f[2]);
+    out->lat_mg = (int32_t)(a[0] * l[0] + a[1] * l[1] + a[2] * l[2]);
+    out->vert_mg = (int32_t)(a[0] * up[0] + a[1] * up[1] + a[2] * up[2] - 1000.0f);
+}
+
+/**
+ * @brief Averages the gyro while the unit is at rest and installs the mean as its zero-rate offset.
+ * @note Runs on every sample until the offset is installed. A sample that moved away from the
+ *       first one of the window restarts the average, so the offset comes from REST_SAMPLES
+ *       consecutive still samples. The estimate is then re-levelled on the mean acceleration.
+ * @param raw: ax, ay, az, gx, gy, gz raw counts.
+ */
+static void attitude_rest(const int16_t *raw)
+{
+    IMUCAL cal;
+    int16_t mean[6];
+    float a[3], d;
+
+    if (rest_count == 0)
+    {
+        for (uint8_t i = 0; i < 6; i++)
+        {
+            rest_ref[i] = raw[i];
+            rest_sum[i] = 0;
+        }
+    }
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        d = (float)(imu_accel_mg(raw[i], i) - imu_accel_mg(rest_ref[i], i));
+        if (fabsf(d) > REST_ACC_SPREAD)
+        {
+            rest_count = 0;
+            return;
+        }
+        d = (float)(imu_gyro_mdps(raw[3 + i], i) - imu_gyro_mdps(rest_ref[3 + i], i));
+        if (fabsf(d) > REST_GYRO_SPREAD)
+        {
+            rest_count = 0;
+            return;
+        }
+    }
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        rest_sum[i] += raw[i];
+    }
+    if (++rest_count < REST_SAMPLES)
+    {
+        return;
+    }
+
+    rest_count = 0;
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        mean[i] = (int16_t)((rest_sum[i] + (rest_sum[i] < 0 ? -REST_SAMPLES / 2 : REST_SAMPLES / 2)) / REST_SAMPLES);
+    }
+    imu_convert_calibration(&cal);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (fabsf((float)(imu_gyro_mdps(mean[3 + i], i) - imu_gyro_mdps(0, i))) > REST_OFFSET_MAX)
+        {
+            return;   // a steady turn, not an offset
+        }
+    }
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        cal.gyro_offset[i] = mean[3 + i];
+    }
+    imu_convert_calibrate(&cal);
+    att_status.gyro_valid = 1;
+
+    accel_mg(mean, a);
+    attitude_level(a);
+    bias[0] = bias[1] = bias[2] = 0.0f;
+    err_hold = 0.0f;
+}
+
+/**
+ * @brief Resets the filter and the mounting estimate to the configured forward axis.
+ */
+void attitude_init(void)
+{
+    fwd_cfg[0] = fwd_cfg[1] = fwd_cfg[2] = 0.0f;
+    fwd_cfg[ATTITUDE_FORWARD_AXIS] = (float)ATTITUDE_FORWARD_SIGN;
+    fwd[0] = fwd_cfg[0];
+    fwd[1] = fwd_cfg[1];
+    fwd[2] = fwd_cfg[2];
+    bias[0] = bias[1] = bias[2] = 0.0f;
+    spp = spq = sqq = 0.0f;
+    yaw_abs_smooth = 0.0f;
+    err_hold = 0.0f;
+    rest_count = 0;
+    started = 0;
+    att_status.gyro_valid = 0;
+    att_status.mount_valid = 0;
+    att_status.mount_yaw_deg = 0.0f;
+    att_status.calib_samples = 0;
+}
+
+/**
+ * @brief Runs the Mahony filter on one sample and returns its motion in the vehicle frame.
+ * @note Main loop, call for every sample in order.
+ * @param f: Sample.
+ * @param out: Vehicle frame acceleration and yaw rate of this sample.
+ */
+void attitude_update(const IMUFRAME *f, VEHICLEMOTION *out)
+{
+    const int16_t *raw = &f->ax;   // ax, ay, az, gx, gy, gz are contiguous
+    float a[3], g[3], e[3];
+    float dt, n, qa, qb, qc;
+    uint32_t dt_us;
+
+    if (!att_status.gyro_valid)
+    {
+        attitude_rest(raw);
+    }
+    accel_mg(raw, a);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        g[i] = (float)imu_gyro_mdps(raw[3 + i], i) * MDPS_TO_RADPS;
+    }
+
+    if (!started)
+    {
+        attitude_level(a);
+        last_us = f->t_us;
+        started = 1;
+    }
+    dt_us = f->t_us - last_us;
+    last_us = f->t_us;
+    dt = (dt_us == 0 || dt_us > DT_MAX_US) ? DT_NOMINAL : dt_us * 1e-6f;
+
+    // PI correction towards gravity while the accelerometer sees little else: close to 1 g
+    // and not turning. Larger disagreement is capped to ERR_GATE, mostly it is vehicle motion
+    n = sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+    if (n > ACC_GATE_LO && n < ACC_GATE_HI && yaw_abs_smooth < CAL_YAW_MAX)
+    {
+        e[0] = (a[1] * up[2] - a[2] * up[1]) / n;
+        e[1] = (a[2] * up[0] - a[0] * up[2]) / n;
+        e[2] = (a[0] * up[1] - a[1] * up[0]) / n;
+        n = sqrtf(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+        if (n > ERR_GATE)
+        {
+            err_hold += dt;
+            n = ERR_GATE / n;
+            e[0] *= n;
+            e[1] *= n;
+            e[2] *= n;
+        }
+        else
+        {
+            err_hold = 0.0f;
+        }
+        if (err_hold > ERR_HOLD_S)
+        {
+            // No manoeuvre lasts this long at close to 1 g, the estimate has drifted away
+            attitude_level(a);
+            err_hold = 0.0f;
+            e[0] = e[1] = e[2] = 0.0f;
+        }
+        for (uint8_t i = 0; i < 3; i++)
+        {
+            bias[i] += KI * e[i] * dt;
+            g[i] += KP * e[i];
+        }
+    }
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        g[i] += bias[i];
+    }
+
+    // q += 0.5 q x (0, g) dt, then renormalise
+    g[0] *= 0.5f * dt;
+    g[1] *= 0.5f * dt;
+    g[2] *= 0.5f * dt;
+    qa = q0;
+    qb = q1;
+    qc = q2;
+    q0 += -qb * g[0] - qc * g[1] - q3 * g[2];
+    q1 += qa * g[0] + qc * g[2] - q3 * g[1];
+    q2 += qa * g[1] - qb * g[2] + q3 * g[0];
+    q3 += qa * g[2] + qb * g[1] - qc * g[0];
+    n = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q0 *= n;
+    q1 *= n;
+    q2 *= n;
+    q3 *= n;
+    attitude_up();
+
+    // Yaw rate is the measured rate about the vertical, without the filter's correction
+    out->yaw_mdps = 0;
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        out->yaw_mdps += imu_gyro_mdps(raw[3 + i], i) * up[i];
+    }
+    yaw_abs_smooth += YAW_SMOOTH * (fabsf((float)out->yaw_mdps) - yaw_abs_smooth);
+    attitude_project(a, out);
+}
+
+/**
+ * @brief Accumulates the horizontal acceleration of straight, level driving into the mounting estimate.
+ * @note Main loop, call for every 100 Hz update of the filter pipeline.
+ * @param s: Pipeline outputs, lp100 is used.
+ */
+void attitude_calibrate(const IMUFILTEROUT *s)
+{
+    float a[3], e1[3], e2[3];
+    float v, p, r, theta;
+
+    if (!started || yaw_abs_smooth > CAL_YAW_MAX)
+    {
+        return;
+    }
+    accel_mg(s->lp100, a);
+    v = a[0] * up[0] + a[1] * up[1] + a[2] * up[2] - 1000.0f;
+    if (fabsf(v) > CAL_VERT_MAX)
+    {
+        return;
+    }
+
+    // Components in a horizontal basis fixed to the configured forward axis
+    attitude_basis(fwd_cfg, e1, e2);
+    p = a[0] * e1[0] + a[1] * e1[1] + a[2] * e1[2];
+    r = a[0] * e2[0] + a[1] * e2[1] + a[2] * e2[2];
+    v = p * p + r * r;
+    if (v < CAL_HORIZ_MIN * CAL_HORIZ_MIN || v > CAL_HORIZ_MAX * CAL_HORIZ_MAX)
+    {
+        return;
+    }
+    spp += p * p;
+    spq += p * r;
+    sqq += r * r;
+    if (++att_status.calib_samples < ATTITUDE_CALIB_SAMPLES)
+    {
+        return;
+    }
+
+    // Principal axis; atan2 / 2 lies within +-90 deg, the half towards the configured forward axis
+    theta = 0.5f * atan2f(2.0f * spq, spp - sqq);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        fwd[i] = cosf(theta) * e1[i] + sinf(theta) * e2[i];
+    }
+    att_status.mount_yaw_deg = theta * RAD_TO_DEG;
+    att_status.mount_valid = 1;
+    att_status.calib_updates++;
+
+    // Keep half the history so later estimates refine instead of starting over
+    spp *= 0.5f;
+    spq *= 0.5f;
+    sqq *= 0.5f;
+    att_status.calib_samples = ATTITUDE_CALIB_SAMPLES / 2;
+}
+
+/**
+ * @brief Projects an accelerometer reading, such as a filtered stream, onto the current vehicle frame.
+ * @param accel_raw: ax, ay, az raw counts.
+ * @param out: Receives lon_mg, lat_mg and vert_mg, yaw_mdps is set to 0.
+ */
+void attitude_to_vehicle(const int16_t accel_raw[3], VEHICLEMOTION *out)
+{
+    float a[3];
+
+    accel_mg(accel_raw, a);
+    attitude_project(a, out);
+    out->yaw_mdps = 0;
+}
+
+/**
+ * @brief Copies the filter and calibration state.
+ * @param status: Destination.
+ */
+void attitude_status(ATTITUDESTATUS *status)
+{
+    att_status.tilt_deg = acosf(up[2] > 1.0f ? 1.0f : up[2] < -1.0f ? -1.0f : up[2]) * RAD_TO_DEG;
+    *status = att_status;
+}
+
+#ifdef ATTITUDE_BENCHMARK
+#include "cycle_counter.h"
+
+/**
+ * @brief Measures the cycles of one attitude_update() on a still, tilted sensor.
+ * @note Build with -DATTITUDE_BENCHMARK, call once after start-up and read the result in the debugger.
+ *       The gyro offset is measured first, so the timing is the one of normal operation. The
+ *       filter is reset afterwards and measures the real offset again.
+ * @param cycles: Average cycles per sample.
+ */
+void attitude_benchmark(uint32_t *cycles)
+{
+    IMUFRAME f = { 0, 300, -200, 2000, 5, -3, 2 };
+    VEHICLEMOTION out;
+    uint32_t start;
+
+    cycle_counter_init();
+    attitude_init();
+    for (uint32_t i = 0; i < REST_SAMPLES; i++)
+    {
+        f.t_us += 1000;
+        attitude_update(&f, &out);
+    }
+    start = CYCLE_COUNTER();
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        f.t_us += 1000;
+        attitude_update(&f, &out);
+    }
+    *cycles = (CYCLE_COUNTER() - start) / 1000;
+    attitude_init();
+}
+#endif /* ATTITUDE_BENCHMARK */
@@ -0,0 +1,89 @@
+/**
+ * @file biquad.c
+ * @brief Fixed-point direct form I biquad sections and integer decimators.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Samples enter as raw int16 counts scaled up by BIQUAD_SIG_SHIFT bits, which
+ * leaves 2^8 of headroom in the 32-bit delay line for overshoot. Each section does
+ * five 32x32->64 multiply-accumulates (SMLAL on the M4) and one rounding shift. The
+ * recursive terms keep the 8 fraction bits, so low corners at 100 Hz, whose poles sit
+ * close to the unit circle, don't stall on rounding or limit-cycle at raw-count
+ * resolution. Coefficients come from Scripts/gen_filter_coeffs.py.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "biquad.h"
+
+/**
+ * @brief Sets a cascade to the steady state of a constant input, avoiding a start-up transient.
+ * @note Each section's output is its DC gain times its input, so a low-pass passes x on
+ *       and a high-pass settles at 0.
+ * @param c: Coefficients, one per section.
+ * @param s: State, one per section.
+ * @param sections: Number of sections.
+ * @param x: Constant input, signal format.
+ */
+void biquad_prime(const BIQUADCOEF *c, BIQUADSTATE *s, uint8_t sections, int32_t x)
+{
+    int64_t num, den;
+
+    for (uint8_t i = 0; i < sections; i++)
+    {
+        num = (int64_t)c[i].b0 + c[i].b1 + c[i].b2;
+        den = (1LL << BIQUAD_COEF_SHIFT) + c[i].a1 + c[i].a2;
+        s[i].x1 = s[i].x2 = x;
+        x = (int32_t)((int64_t)x * num / den);
+        s[i].y1 = s[i].y2 = x;
+    }
+}
+
+/**
+ * @brief Filters one sample through a cascade.
+ * @param c: Coefficients, one per section.
+ * @param s: State, one per section.
+ * @param sections: Number of sections.
+ * @param x: Input, signal format.
+ * @return Output, signal format.
+ */
+int32_t biquad_run(const BIQUADCOEF *c, BIQUADSTATE *s, uint8_t sections, int32_t x)
+{
+    int64_t acc;
+    int32_t y;
+
+    for (uint8_t i = 0; i < sections; i++)
+    {
+        acc = (int64_t)c[i].b0 * x;
+        acc += (int64_t)c[i].b1 * s[i].x1;
+        acc += (int64_t)c[i].b2 * s[i].x2;
+        acc -= (int64_t)c[i].a1 * s[i].y1;
+        acc -= (int64_t)c[i].a2 * s[i].y2;
+        y = (int32_t)((acc + (1LL << (BIQUAD_COEF_SHIFT - 1))) >> BIQUAD_COEF_SHIFT);
+
+        s[i].x2 = s[i].x1;
+        s[i].x1 = x;
+        s[i].y2 = s[i].y1;
+        s[i].y1 = y;
+        x = y;
+    }
+    return x;
+}
+
+/**
+ * @brief Advances a decimator by one input sample.
+ * @param d: Decimator.
+ * @return 1 when this sample is kept, every factor-th one starting with the first.
+ */
+uint8_t decimator_step(DECIMATOR *d)
+{
+    uint8_t keep = (d->phase == 0);
+
+    d->phase = (d->phase + 1 == d->factor) ? 0 : d->phase + 1;
+    return keep;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file blackbox.c
+ * @brief Crash recorder keeping seconds of full-rate IMU data around an impact in CCM RAM.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Every imu_ring block is copied into a ring of BLACKBOX_BLOCKS in the 64 KB
+ * core coupled memory, which nothing else uses and which the CPU reaches without
+ * competing with DMA on the main SRAM bus. CCM is not reachable by DMA, the SD card
+ * SPI transfers are polled so the file system can write from it directly. An
+ * acceleration magnitude past BLACKBOX_TRIGGER_MG keeps recording for
+ * BLACKBOX_POST_BLOCKS, then freezes the ring and blackbox_service() streams it to a
+ * new file a few blocks per main loop pass. Acquisition never waits for the card:
+ * the FIFO keeps filling the imu_ring from interrupts, and blocks arriving while
+ * the frozen ring is written are counted as skipped, not stored over it.
+ * 10 s at 1 kHz of 6-DoF int16 would need 120 KB, the ring holds 5.12 s instead.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+/**
+ * User-defined libraries
+ */
+#include "blackbox.h"
+#include "fatfs.h"
+#include "gps_time.h"
+#include "mpu6050.h"
+
+/**
+ * User defined Macros
+ */
+#define ACCEL_LSB_PER_G	(16384 >> MPU6050_ACCEL_FS_SEL)
+#define TRIGGER_RAW		((uint32_t)BLACKBOX_TRIGGER_MG * ACCEL_LSB_PER_G / 1000)
+#define MAX_FILES		(1000)
+
+#if BLACKBOX_POST_BLOCKS >= BLACKBOX_BLOCKS
+#error "BLACKBOX_POST_BLOCKS must leave room for pre-trigger blocks"
+#endif
+
+/**
+ * User defined variables
+ */
+static BBBLOCK bb_ring[BLACKBOX_BLOCKS] __attribute__((section(".ccmbss")));
+static uint16_t bb_head = 0;          // next block to record
+static uint16_t bb_count = 0;         // valid blocks, up to BLACKBOX_BLOCKS
+static uint16_t bb_post_left = 0;
+static uint16_t bb_trigger_index = 0; // ring index of the triggering block
+static uint32_t bb_peak_sq = 0;       // squared raw magnitude
+static uint16_t bb_written = 0;       // blocks of the frozen ring already on the card
+static BLACKBOXSTATE bb_state = BLACKBOX_RECORDING;
+static BBHEADER bb_header;
+static char bb_name[32];
+static BLACKBOXSTATS bb_stats;
+
+/**
+ * @brief Empties the recorder, the CCM content is not cleared since only bb_count blocks of it are read.
+ */
+void blackbox_init(void)
+{
+    bb_head = 0;
+    bb_count = 0;
+    bb_state = BLACKBOX_RECORDING;
+}
+
+/**
+ * @brief Latches the trigger time and starts the post-trigger capture.
+ * @param t_us: Timestamp of the triggering sample.
+ */
+static void blackbox_trigger(uint32_t t_us)
+{
+    uint64_t utc_ms = gps_time_valid() ? gps_time_now_ms() : 0;
+
+    bb_state = BLACKBOX_POST;
+    bb_post_left = BLACKBOX_POST_BLOCKS;
+    bb_trigger_index = bb_head;
+    bb_peak_sq = 0;
+    bb_stats.triggers++;
+
+    bb_header.trigger_us = t_us;
+    bb_header.trigger_utc_s = (uint32_t)(utc_ms / 1000);
+    bb_header.trigger_utc_ms = (uint16_t)(utc_ms % 1000);
+}
+
+/**
+ * @brief Freezes the ring and fills in the header for blackbox_service().
+ */
+static void blackbox_freeze(void)
+{
+    uint16_t oldest = (bb_count < BLACKBOX_BLOCKS) ? 0 : bb_head;
+
+    bb_header.magic[0] = 'B';
+    bb_header.magic[1] = 'B';
+    bb_header.magic[2] = 'X';
+    bb_header.magic[3] = '1';
+    bb_header.sample_rate_hz = MPU6050_SAMPLE_RATE_HZ;
+    bb_header.block_len = IMU_BLOCK_LEN;
+    bb_header.blocks = bb_count;
+    bb_header.trigger_block = (bb_trigger_index + BLACKBOX_BLOCKS - oldest) % BLACKBOX_BLOCKS;
+    bb_header.peak_mg = (uint16_t)(sqrtf((float)bb_peak_sq) * 1000.0f / ACCEL_LSB_PER_G);   // once per recording
+    bb_state = BLACKBOX_WRITING;
+    bb_written = 0;
+    bb_name[0] = '\0';
+}
+
+/**
+ * @brief Records one imu_ring block and checks its samples for an impact.
+ * @note Main loop, call for every block in order. Three multiply-adds and a compare per sample.
+ * @param block: IMU_BLOCK_LEN samples.
+ */
+void blackbox_block(const IMUFRAME *block)
+{
+    BBBLOCK *b;
+    uint32_t mag_sq;
+
+    if (bb_state == BLACKBOX_WRITING)
+    {
+        bb_stats.skipped_blocks++;
+        return;
+    }
+
+    b = &bb_ring[bb_head];
+    b->t_us = block[0].t_us;
+    for (uint16_t i = 0; i < IMU_BLOCK_LEN; i++)
+    {
+        b->s[i][0] = block[i].ax;
+        b->s[i][1] = block[i].ay;
+        b->s[i][2] = block[i].az;
+        b->s[i][3] = block[i].gx;
+        b->s[i][4] = block[i].gy;
+        b->s[i][5] = block[i].gz;
+
+        // Each square is at most 2^30, so the sum of three fits unsigned 32 bits
+        mag_sq = (uint32_t)((int32_t)block[i].ax * block[i].ax) + (uint32_t)((int32_t)block[i].ay * block[i].ay)
+               + (uint32_t)((int32_t)block[i].az * block[i].az);
+        if (bb_state == BLACKBOX_RECORDING && mag_sq >= TRIGGER_RAW * TRIGGER_RAW)
+        {
+            blackbox_trigger(block[i].t_us);
+        }
+        if (bb_state == BLACKBOX_POST && mag_sq > bb_peak_sq)
+        {
+            bb_peak_sq = mag_sq;
+        }
+    }
+
+    bb_head = (bb_head + 1 == BLACKBOX_BLOCKS) ? 0 : bb_head + 1;
+    if (bb_count < BLACKBOX_BLOCKS)
+    {
+        bb_count++;
+    }
+
+    if (bb_state == BLACKBOX_POST && --bb_post_left == 0)
+    {
+        blackbox_freeze();
+    }
+}
+
+/**
+ * @brief Abandons the frozen recording and goes back to recording.
+ * @param ok: 1 when the file was completed.
+ */
+static void blackbox_done(uint8_t ok)
+{
+    if (ok)
+    {
+        bb_stats.files++;
+    }
+    else
+    {
+        bb_stats.write_errors++;
+    }
+    blackbox_init();
+}
+
+/**
+ * @brief Streams up to BLACKBOX_WRITE_BLOCKS blocks of a frozen recording to the SD card.
+ * @note Main loop. The first call creates Blackbox_Crash_NNN.bin and writes the header.
+ *       The file is closed after every call like the other logs, so an unmounted card
+ *       or a reset loses at most the blocks of one call.
+ */
+void blackbox_service(void)
+{
+    uint16_t oldest, index;
+    UINT bw;
+    FRESULT res;
+
+    if (bb_state != BLACKBOX_WRITING)
+    {
+        return;
+    }
+
+    f_mount(&USERFatFS, "", 0);
+    if (bb_name[0] == '\0')
+    {
+        res = FR_EXIST;
+        for (uint16_t n = 0; n < MAX_FILES && res == FR_EXIST; n++)
+        {
+            snprintf(bb_name, sizeof(bb_name), "Blackbox_Crash_%03u.bin", n);
+            res = f_open(&USERFile, bb_name, FA_CREATE_NEW | FA_WRITE);
+        }
+        if (res != FR_OK)
+        {
+            blackbox_done(0);
+            return;
+        }
+        res = f_write(&USERFile, &bb_header, sizeof(bb_header), &bw);
+    }
+    else
+    {
+        res = f_open(&USERFile, bb_name, FA_OPEN_APPEND | FA_WRITE);
+        if (res != FR_OK)
+        {
+            blackbox_done(0);
+            return;
+        }
+    }
+
+    // Oldest block first, the ring started at index 0 until it filled up once
+    oldest = (bb_count < BLACKBOX_BLOCKS) ? 0 : bb_head;
+    for (uint16_t i = 0; i < BLACKBOX_WRITE_BLOCKS && res == FR_OK && bb_written < bb_count; i++)
+    {
+        index = (oldest + bb_written) % BLACKBOX_BLOCKS;
+        res = f_write(&USERFile, &bb_ring[index], sizeof(BBBLOCK), &bw);
+        if (bw != sizeof(BBBLOCK))
+        {
+            res = FR_DISK_ERR;   // card full
+        }
+        bb_written++;
+    }
+
+    if (f_close(&USERFile) != FR_OK || res != FR_OK)
+    {
+        blackbox_done(0);
+    }
+    else if (bb_written == bb_count)
+    {
+        blackbox_done(1);
+    }
+}
+
+/**
+ * @brief Reports what the recorder is doing.
+ * @return State.
+ */
+BLACKBOXSTATE blackbox_state(void)
+{
+    return bb_state;
+}
+
+/**
+ * @brief Copies the recorder counters.
+ * @param stats: Destination.
+ */
+void blackbox_stats(BLACKBOXSTATS *stats)
+{
+    *stats = bb_stats;
+}
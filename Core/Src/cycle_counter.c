@@ -0,0 +1,22 @@
+/**
+ * @file cycle_counter.c
+ * @brief DWT cycle counter used to measure code paths on the target.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+/**
+ * User-defined libraries
+ */
+#include "cycle_counter.h"
+
+/**
+ * @brief Enables the trace block and starts the free-running DWT cycle counter.
+ * @param None
+ */
+void cycle_counter_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;   // DWT is part of the trace block
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
@@ -0,0 +1,354 @@
+/**
+ * @file dsp_kernels.c
+ * @brief Block reductions over int16 samples using the Cortex-M4 dual 16-bit SIMD instructions.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Two samples are loaded per 32-bit word. SMLAD against 0x00010001 adds both halves
+ * to the sum, SMLALD multiplies and accumulates both pairs into 64 bits for the sum of
+ * squares and the dot product, and SSUB16 sets the GE flags per lane so SEL keeps the
+ * smaller or larger half without a branch. Integer arithmetic makes every kernel exact,
+ * so each one returns the same bits as its scalar reference. Without the DSP extension
+ * the kernels fall back to the references.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "stm32f4xx.h"
+#include "dsp_kernels.h"
+
+/**
+ * User defined Macros
+ */
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define DSP_SIMD		(1)
+#define PAIR(p)			__UNALIGNED_UINT32_READ(p)	// two samples, low half first
+#define ONES			(0x00010001UL)
+#endif
+
+/**
+ * @brief Sum of a block, scalar reference.
+ * @param x: Samples.
+ * @param n: Sample count.
+ * @return Sum.
+ */
+int32_t dsp_sum_i16_ref(const int16_t *x, uint32_t n)
+{
+    int32_t sum = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sum += x[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Sum of squares of a block, scalar reference.
+ * @param x: Samples.
+ * @param n: Sample count.
+ * @return Sum of squares.
+ */
+int64_t dsp_sumsq_i16_ref(const int16_t *x, uint32_t n)
+{
+    int64_t sum = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sum += (int32_t)x[i] * x[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Dot product of two blocks, scalar reference.
+ * @param a: First block.
+ * @param b: Second block.
+ * @param n: Sample count.
+ * @return Sum of a[i] * b[i].
+ */
+int64_t dsp_dot_i16_ref(const int16_t *a, const int16_t *b, uint32_t n)
+{
+    int64_t sum = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sum += (int32_t)a[i] * b[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Smallest sample of a block, scalar reference.
+ * @param x: Samples.
+ * @param n: Sample count, at least 1.
+ * @return Minimum.
+ */
+int16_t dsp_min_i16_ref(const int16_t *x, uint32_t n)
+{
+    int16_t m = x[0];
+
+    for (uint32_t i = 1; i < n; i++)
+    {
+        m = (x[i] < m) ? x[i] : m;
+    }
+    return m;
+}
+
+/**
+ * @brief Largest sample of a block, scalar reference.
+ * @param x: Samples.
+ * @param n: Sample count, at least 1.
+ * @return Maximum.
+ */
+int16_t dsp_max_i16_ref(const int16_t *x, uint32_t n)
+{
+    int16_t m = x[0];
+
+    for (uint32_t i = 1; i < n; i++)
+    {
+        m = (x[i] > m) ? x[i] : m;
+    }
+    return m;
+}
+
+#ifdef DSP_SIMD
+/**
+ * @brief Sum of a block.
+ * @param x: Samples.
+ * @param n: Sample count.
+ * @return Sum.
+ */
+int32_t dsp_sum_i16(const int16_t *x, uint32_t n)
+{
+    uint32_t acc = 0;
+    uint32_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        acc = __SMLAD(PAIR(&x[i]), ONES, acc);
+        acc = __SMLAD(PAIR(&x[i + 2]), ONES, acc);
+    }
+    for (; i < n; i++)
+    {
+        acc += (uint32_t)(int32_t)x[i];
+    }
+    return (int32_t)acc;
+}
+
+/**
+ * @brief Sum of squares of a block.
+ * @param x: Samples.
+ * @param n: Sample count.
+ * @return Sum of squares.
+ */
+int64_t dsp_sumsq_i16(const int16_t *x, uint32_t n)
+{
+    uint64_t acc = 0;
+    uint32_t i = 0;
+    uint32_t p;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        p = PAIR(&x[i]);
+        acc = __SMLALD(p, p, acc);
+        p = PAIR(&x[i + 2]);
+        acc = __SMLALD(p, p, acc);
+    }
+    for (; i < n; i++)
+    {
+        acc += (uint64_t)(int64_t)((int32_t)x[i] * x[i]);
+    }
+    return (int64_t)acc;
+}
+
+/**
+ * @brief Dot product of two blocks.
+ * @param a: First block.
+ * @param b: Second block.
+ * @param n: Sample count.
+ * @return Sum of a[i] * b[i].
+ */
+int64_t dsp_dot_i16(const int16_t *a, const int16_t *b, uint32_t n)
+{
+    uint64_t acc = 0;
+    uint32_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        acc = __SMLALD(PAIR(&a[i]), PAIR(&b[i]), acc);
+        acc = __SMLALD(PAIR(&a[i + 2]), PAIR(&b[i + 2]), acc);
+    }
+    for (; i < n; i++)
+    {
+        acc += (uint64_t)(int64_t)((int32_t)a[i] * b[i]);
+    }
+    return (int64_t)acc;
+}
+
+/**
+ * @brief Smallest sample of a block.
+ * @note SSUB16 sets GE for lanes where m >= x, SEL then takes those lanes from x.
+ *       The pair of lane minima is folded into one value at the end.
+ * @param x: Samples.
+ * @param n: Sample count, at least 1.
+ * @return Minimum.
+ */
+int16_t dsp_min_i16(const int16_t *x, uint32_t n)
+{
+    uint32_t i = 0;
+    uint32_t m, p;
+    int16_t lo, hi;
+
+    if (n < 2)
+    {
+        return x[0];
+    }
+    m = PAIR(&x[0]);
+    for (i = 2; i + 2 <= n; i += 2)
+    {
+        p = PAIR(&x[i]);
+        __SSUB16(m, p);
+        m = __SEL(p, m);
+    }
+    lo = (int16_t)(m & 0xFFFF);
+    hi = (int16_t)(m >> 16);
+    lo = (hi < lo) ? hi : lo;
+    if (i < n)
+    {
+        lo = (x[i] < lo) ? x[i] : lo;
+    }
+    return lo;
+}
+
+/**
+ * @brief Largest sample of a block.
+ * @note SSUB16 sets GE for lanes where x >= m, SEL then takes those lanes from x.
+ * @param x: Samples.
+ * @param n: Sample count, at least 1.
+ * @return Maximum.
+ */
+int16_t dsp_max_i16(const int16_t *x, uint32_t n)
+{
+    uint32_t i = 0;
+    uint32_t m, p;
+    int16_t lo, hi;
+
+    if (n < 2)
+    {
+        return x[0];
+    }
+    m = PAIR(&x[0]);
+    for (i = 2; i + 2 <= n; i += 2)
+    {
+        p = PAIR(&x[i]);
+        __SSUB16(p, m);
+        m = __SEL(p, m);
+    }
+    lo = (int16_t)(m & 0xFFFF);
+    hi = (int16_t)(m >> 16);
+    lo = (hi > lo) ? hi : lo;
+    if (i < n)
+    {
+        lo = (x[i] > lo) ? x[i] : lo;
+    }
+    return lo;
+}
+#else
+int32_t dsp_sum_i16(const int16_t *x, uint32_t n) { return dsp_sum_i16_ref(x, n); }
+
+int64_t dsp_sumsq_i16(const int16_t *x, uint32_t n) { return dsp_sumsq_i16_ref(x, n); }
+
+int64_t dsp_dot_i16(const int16_t *a, const int16_t *b, uint32_t n) { return dsp_dot_i16_ref(a, b, n); }
+
+int16_t dsp_min_i16(const int16_t *x, uint32_t n) { return dsp_min_i16_ref(x, n); }
+
+int16_t dsp_max_i16(const int16_t *x, uint32_t n) { return dsp_max_i16_ref(x, n); }
+#endif /* DSP_SIMD */
+
+#ifdef DSP_BENCHMARK
+#include "cycle_counter.h"
+
+/**
+ * User defined Macros
+ */
+#define BENCH_SAMPLES	(1000)	// one second at the 1 kHz sample rate
+#define BENCH_AXES		(3)
+
+/**
+ * User defined variables
+ */
+static int16_t bench_data[BENCH_AXES][BENCH_SAMPLES + 1];
+
+/**
+ * @brief Checks every kernel against its reference and times both on one second of 3-axis data.
+ * @note Build with -DDSP_BENCHMARK, call once after start-up and read the result in the debugger.
+ *       Block lengths 0..BENCH_SAMPLES and both word alignments are compared, the timing uses
+ *       sum, sum of squares, min and max per axis, what a window reduction needs.
+ * @param result: Mismatch count and cycles.
+ */
+void dsp_benchmark(DSPBENCH *result)
+{
+    volatile int64_t sink = 0;
+    uint32_t seed = 12345;
+    uint32_t start;
+
+    // Pseudo-random full-range samples, xorshift so the run is repeatable
+    for (uint32_t a = 0; a < BENCH_AXES; a++)
+    {
+        for (uint32_t i = 0; i <= BENCH_SAMPLES; i++)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            bench_data[a][i] = (int16_t)seed;
+        }
+    }
+
+    result->mismatches = 0;
+    for (uint32_t off = 0; off < 2; off++)
+    {
+        const int16_t *x = &bench_data[0][off];
+        const int16_t *y = &bench_data[1][off];
+
+        for (uint32_t n = 0; n <= BENCH_SAMPLES; n += (n < 16) ? 1 : 37)
+        {
+            result->mismatches += dsp_sum_i16(x, n) != dsp_sum_i16_ref(x, n);
+            result->mismatches += dsp_sumsq_i16(x, n) != dsp_sumsq_i16_ref(x, n);
+            result->mismatches += dsp_dot_i16(x, y, n) != dsp_dot_i16_ref(x, y, n);
+            if (n > 0)
+            {
+                result->mismatches += dsp_min_i16(x, n) != dsp_min_i16_ref(x, n);
+                result->mismatches += dsp_max_i16(x, n) != dsp_max_i16_ref(x, n);
+            }
+        }
+    }
+
+    cycle_counter_init();
+    start = CYCLE_COUNTER();
+    for (uint32_t a = 0; a < BENCH_AXES; a++)
+    {
+        sink = dsp_sum_i16_ref(bench_data[a], BENCH_SAMPLES);
+        sink = dsp_sumsq_i16_ref(bench_data[a], BENCH_SAMPLES);
+        sink = dsp_min_i16_ref(bench_data[a], BENCH_SAMPLES);
+        sink = dsp_max_i16_ref(bench_data[a], BENCH_SAMPLES);
+    }
+    result->ref_cycles = CYCLE_COUNTER() - start;
+
+    start = CYCLE_COUNTER();
+    for (uint32_t a = 0; a < BENCH_AXES; a++)
+    {
+        sink = dsp_sum_i16(bench_data[a], BENCH_SAMPLES);
+        sink = dsp_sumsq_i16(bench_data[a], BENCH_SAMPLES);
+        sink = dsp_min_i16(bench_data[a], BENCH_SAMPLES);
+        sink = dsp_max_i16(bench_data[a], BENCH_SAMPLES);
+    }
+    result->simd_cycles = CYCLE_COUNTER() - start;
+    (void)sink;
+}
+#endif /* DSP_BENCHMARK */
@@ -22,6 +22,10 @@
 #include "fatfs.h"
 #include "fatfs_sd.h"
 #include "string.h"
+#include "gps_time.h"
+#include "window_stats.h"
+#include "maneuver.h"
+#include "timestamp.h"
 
 /**
  * File system and file variables
@@ -34,14 +38,11 @@ UINT br1, bw1; //file read/write count
  * User defined Macros
  */
 #define DATA_VALS		(50)
-#define X_RAW_IDLE		(-40)
-#define X_RAW_LRANGE	(60)
-#define X_HIGH			(-20)
-#define X_LOW			(-70)
-#define Y_HIGH			(-100)
-#define Y_LOW			(-140)
-#define Y_RAW_IDLE		(-120)
-#define Z_RAW_IDLE		(2090)
+// Vehicle frame limits in mg, the old raw count bands around the idle readings at 2048 LSB/g
+#define LAT_HIGH		(10)	// X_HIGH -20 against X_RAW_IDLE -40
+#define LAT_LOW			(-15)	// X_LOW -70
+#define LON_HIGH		(10)	// Y_HIGH -100 against Y_RAW_IDLE -120
+#define LON_LOW			(-10)	// Y_LOW -140
 
 /**
  * User defined variables
@@ -56,18 +57,98 @@ uint16_t irregular_accel = 0;
 uint16_t rash_driving = 0;
 int16_t buffer_min[3] = {0};
 int16_t buffer_max[3] = {0};
+float buffer_variance[3] = {0};
+WINSTATS axis_window[3]; // sliding DATA_VALS entry window per vehicle axis
+uint16_t entries_since_log = 0;
+uint8_t lane_active = 0;
+uint8_t accel_active = 0;
+uint8_t rash_active = 0;
 
 /**
- * @brief Analyzes the input buffers for x, y, and z axes, calculates averages and checks for events.
- * @param xbuffer: Buffer for x-axis data
- * @param ybuffer: Buffer for y-axis data
- * @param zbuffer: Buffer for z-axis data
+ * @brief Empties the sliding windows, call before the first event_update.
  */
-void event_analysis(int16_t xbuffer[], int16_t ybuffer[], int16_t zbuffer[])
+void event_init(void)
 {
-    buf_analysis(xbuffer, 0);
-    buf_analysis(ybuffer, 1);
-    buf_analysis(zbuffer, 2);
+    for (int i = 0; i < 3; i++)
+    {
+        winstats_init(&axis_window[i], DATA_VALS);
+    }
+    entries_since_log = 0;
+    lane_active = accel_active = rash_active = 0;
+}
+
+/**
+ * @brief Slides one vehicle frame window entry into the statistics and checks for events.
+ * @note O(1) per entry, so the thresholds are evaluated on every entry over the last
+ *       DATA_VALS entries instead of once per tumbling 5 second block. An event is counted
+ *       when its condition starts to hold, not on every entry it keeps holding.
+ * @param lat: Lateral acceleration in mg, positive to the left
+ * @param lon: Longitudinal acceleration in mg, positive forward
+ * @param vert: Vertical acceleration in mg without gravity
+ */
+void event_update(int16_t lat, int16_t lon, int16_t vert)
+{
+    uint8_t lane, accel;
+
+    winstats_push(&axis_window[0], lat);
+    winstats_push(&axis_window[1], lon);
+    winstats_push(&axis_window[2], vert);
+    buf_analysis(0);
+    buf_analysis(1);
+    buf_analysis(2);
+
+    if (entries_since_log < DATA_VALS)
+    {
+        entries_since_log++;
+    }
+
+    // Wait for a full window so start-up entries do not trip the thresholds
+    if (axis_window[0].count < DATA_VALS)
+    {
+        return;
+    }
+
+    // Check for specific events based on threshold values
+    lane = (buffer_average[0] > LAT_HIGH || buffer_average[0] < LAT_LOW);
+    accel = (buffer_average[1] > LON_HIGH || buffer_average[1] < LON_LOW);
+
+    if (lane && !lane_active)
+    {
+        lane_change++;
+    }
+
+    if (accel && !accel_active)
+    {
+        irregular_accel++;
+    }
+
+    if (lane && accel && !rash_active)
+    {
+        rash_driving++;
+    }
+    lane_active = lane;
+    accel_active = accel;
+    rash_active = lane && accel;
+}
+
+/**
+ * @brief Reports whether a new 5 second average is due on the SD card.
+ * @return 1 once DATA_VALS entries have slid in since the last event_log, else 0
+ */
+uint8_t event_log_due(void)
+{
+    return entries_since_log >= DATA_VALS;
+}
+
+/**
+ * @brief Writes the current window averages to the SD card.
+ * @note Kept out of event_update so the file system runs from the main loop, not per entry.
+ */
+void event_log(void)
+{
+    uint64_t utc_ms;
+
+    entries_since_log = 0;
 
     // Convert buffer averages to ASCII strings
     goToAscii(buffer_average[0], char_buf_avg0);
@@ -83,64 +164,68 @@ void event_analysis(int16_t xbuffer[], int16_t ybuffer[], int16_t zbuffer[])
     // Move file pointer to the end of the file
     f_lseek(&fil1, f_size(&fil1));
 
+    // Stamp the record with the GPS disciplined UTC time, 0 until the first fix
+    utc_ms = gps_time_now_ms();
+    f_printf(&fil1, "UTC: %lu.%03u\n", (unsigned long)(utc_ms / 1000), (unsigned int)(utc_ms % 1000));
+
     // Write average values to the file
-    f_puts("The average value over the past 5 seconds for x axis: ", &fil1);
+    f_puts("The average lateral acceleration in mg over the past 5 seconds: ", &fil1);
     f_write(&fil1, char_buf_avg0, sizeof(char_buf_avg0), &bw1);
     f_puts("\n", &fil1);
 
-    f_puts("The average value over the past 5 seconds for y axis: ", &fil1);
+    f_puts("The average longitudinal acceleration in mg over the past 5 seconds: ", &fil1);
     f_write(&fil1, char_buf_avg1, sizeof(char_buf_avg1), &bw1);
     f_puts("\n", &fil1);
 
-    f_puts("The average value over the past 5 seconds for z axis: ", &fil1);
+    f_puts("The average vertical acceleration in mg over the past 5 seconds: ", &fil1);
     f_write(&fil1, char_buf_avg2, sizeof(char_buf_avg2), &bw1);
     f_puts("\n", &fil1);
 
     // Close the file
     f_close(&fil1);
+}
 
-    // Check for specific events based on threshold values
-    if (buffer_average[0] > X_HIGH || buffer_average[0] < X_LOW)
-    {
-        lane_change++;
-    }
+/**
+ * @brief Appends one finished maneuver to the SD card.
+ * @note UTC of the start is back-dated from now by the age of the event on the TIM2 clock.
+ * @param m: Event from maneuver_pop().
+ */
+void event_maneuver(const MANEUVER *m)
+{
+    static const char *const names[MANEUVER_KINDS] = { "Harsh braking", "Harsh acceleration", "Harsh cornering" };
+    uint64_t utc_ms = gps_time_now_ms();
+    uint32_t age_ms = (TIMESTAMP_US() - m->start_us) / 1000;
 
-    if (buffer_average[1] > Y_HIGH || buffer_average[1] < Y_LOW)
+    if (utc_ms >= age_ms)
     {
-        irregular_accel++;
+        utc_ms -= age_ms;
     }
 
-    if ((buffer_average[0] > X_HIGH || buffer_average[0] < X_LOW) &&
-        (buffer_average[1] > Y_HIGH || buffer_average[1] < Y_LOW))
-    {
-        rash_driving++;
-    }
+    f_mount(&fs1, "", 0);
+    f_open(&fil1, "Blackbox_Maneuvers.txt", FA_OPEN_ALWAYS | FA_WRITE | FA_READ);
+    f_lseek(&fil1, f_size(&fil1));
+
+    f_printf(&fil1, "UTC: %lu.%03u %s for %u ms, peak %u mg, jerk %u mg/s, yaw %u deg/s\n",
+             (unsigned long)(utc_ms / 1000), (unsigned int)(utc_ms % 1000), names[m->kind],
+             m->duration_ms, m->peak_mg, m->peak_jerk, m->peak_yaw_dps);
+
+    f_close(&fil1);
 }
 
 /**
- * @brief Calculates statistics for the input buffer (minimum, maximum, range, average).
- * @param input_buffer: Input data buffer
- * @param index: Index indicating the axis (0 for x, 1 for y, 2 for z)
+ * @brief Copies the window statistics of one axis (minimum, maximum, range, average, variance).
+ * @param index: Index indicating the axis (0 lateral, 1 longitudinal, 2 vertical)
  */
-void buf_analysis(int16_t input_buffer[], int index)
+void buf_analysis(int index)
 {
-    int32_t sum = 0;
-    int16_t minimum_final = input_buffer[0];
-    int16_t maximum_final = input_buffer[0];
-
-    // Iterate through the buffer to find minimum, maximum, and calculate the sum
-    for (int i = 0; i < DATA_VALS; i++)
-    {
-        minimum_final = (minimum_final < input_buffer[i]) ? minimum_final : input_buffer[i];
-        maximum_final = (maximum_final > input_buffer[i]) ? maximum_final : input_buffer[i];
-        sum += input_buffer[i];
-    }
+    const WINSTATS *w = &axis_window[index];
 
     // Update the statistics in the corresponding arrays
-    buffer_min[index] = minimum_final;
-    buffer_max[index] = maximum_final;
-    buffer_range[index] = maximum_final - minimum_final;
-    buffer_average[index] = sum / DATA_VALS;
+    buffer_min[index] = winstats_min(w);
+    buffer_max[index] = winstats_max(w);
+    buffer_range[index] = buffer_max[index] - buffer_min[index];
+    buffer_average[index] = winstats_mean(w);
+    buffer_variance[index] = winstats_variance(w);
 }
 
 
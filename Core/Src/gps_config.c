@@ -0,0 +1,348 @@
+/**
+ * @file gps_config.c
+ * @brief GPS receiver configuration: update rate, baud rate and NMEA sentence output.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Talks to the u-blox receiver with UBX CFG messages and waits for the
+ * matching ACK-ACK / ACK-NAK. The settings are not saved in the receiver, so
+ * GPS_configure() is called after every reset of the board. It finds the baud
+ * rate the receiver is currently using first, because the receiver keeps its
+ * settings across a reset of the STM32 as long as it stays powered.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * User-defined libraries
+ */
+#include "main.h"
+#include "systick.h"
+#include "uart.h"
+#include "gps_config.h"
+
+/**
+ * User defined Macros
+ */
+#define UBX_SYNC1			(0xB5)
+#define UBX_SYNC2			(0x62)
+#define UBX_CLASS_ACK		(0x05)
+#define UBX_ID_ACK_NAK		(0x00)
+#define UBX_ID_ACK_ACK		(0x01)
+#define UBX_CLASS_CFG		(0x06)
+#define UBX_ID_CFG_PRT		(0x00)
+#define UBX_ID_CFG_MSG		(0x01)
+#define UBX_ID_CFG_RATE		(0x08)
+#define UBX_CLASS_NMEA		(0xF0)
+#define UBX_MAX_PAYLOAD		(20)
+#define UBX_FRAME_OVERHEAD	(8)			// sync, class, id, length, checksum
+#define UBX_PORT_UART1		(1)
+#define UBX_MODE_8N1		(0x000008D0)
+#define UBX_PROTO_UBX_NMEA	(0x0003)
+#define GPS_BAUD_SETTLE_MS	(100)		// receiver switches after the ACK has left
+
+/**
+ * @brief States of the acknowledgement matcher, frame is B5 62 05 id 02 00 cls id ckA ckB.
+ */
+typedef enum {
+    ACK_SYNC1 = 0,
+    ACK_SYNC2,
+    ACK_CLASS,
+    ACK_ID,
+    ACK_BODY
+} ACKSTATE;
+
+/**
+ * User defined variables
+ */
+volatile uint8_t gps_config_listening = 0;
+static volatile uint8_t ack_received = 0;      // 1 on ACK-ACK, 2 on ACK-NAK for the awaited command
+static uint8_t ack_class = 0;                  // command being waited for
+static uint8_t ack_id = 0;
+static ACKSTATE ack_state = ACK_SYNC1;
+static uint8_t ack_frame_id = 0;
+static uint8_t ack_body[6];
+static uint8_t ack_body_len = 0;
+
+/**
+ * NMEA message IDs in UBX class 0xF0, indexed by NMEATYPE
+ */
+static const uint8_t ubx_nmea_id[NMEA_TYPE_COUNT] = {
+    [NMEA_UNKNOWN] = 0xFF,
+    [NMEA_GGA] = 0x00,
+    [NMEA_GLL] = 0x01,
+    [NMEA_GSA] = 0x02,
+    [NMEA_GSV] = 0x03,
+    [NMEA_RMC] = 0x04,
+    [NMEA_VTG] = 0x05,
+};
+
+/**
+ * @brief Baud rates probed when the receiver does not answer at the requested one.
+ */
+static const uint32_t gps_probe_baud[] = { UART2_DEFAULT_BAUD, 38400, 115200 };
+
+/**
+ * @brief Matches received bytes against the ACK for the awaited command.
+ * @note Runs in the USART2 receive interrupt while gps_config_listening is set.
+ * @param data: Received bytes.
+ * @param len: Number of bytes.
+ */
+void gps_config_feed(const uint8_t *data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        uint8_t c = data[i];
+
+        switch (ack_state)
+        {
+            case ACK_SYNC1:
+                if (c == UBX_SYNC1) ack_state = ACK_SYNC2;
+                break;
+            case ACK_SYNC2:
+                ack_state = (c == UBX_SYNC2) ? ACK_CLASS : ACK_SYNC1;
+                break;
+            case ACK_CLASS:
+                ack_state = (c == UBX_CLASS_ACK) ? ACK_ID : ACK_SYNC1;
+                break;
+            case ACK_ID:
+                ack_frame_id = c;
+                ack_body_len = 0;
+                ack_state = (c == UBX_ID_ACK_ACK || c == UBX_ID_ACK_NAK) ? ACK_BODY : ACK_SYNC1;
+                break;
+            case ACK_BODY:
+                // length (2 0), acknowledged class and id, checksum
+                ack_body[ack_body_len++] = c;
+                if (ack_body_len == sizeof(ack_body))
+                {
+                    uint8_t ck_a = UBX_CLASS_ACK + ack_frame_id;
+                    uint8_t ck_b = UBX_CLASS_ACK + ck_a;
+
+                    for (uint8_t k = 0; k < 4; k++)
+                    {
+                        ck_a += ack_body[k];
+                        ck_b += ck_a;
+                    }
+                    if (ck_a == ack_body[4] && ck_b == ack_body[5] &&
+                        ack_body[0] == 2 && ack_body[1] == 0 &&
+                        ack_body[2] == ack_class && ack_body[3] == ack_id)
+                    {
+                        ack_received = (ack_frame_id == UBX_ID_ACK_ACK) ? 1 : 2;
+                    }
+                    ack_state = ACK_SYNC1;
+                }
+                break;
+            default:
+                ack_state = ACK_SYNC1;
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Frames a UBX message and queues it on the UART2 transmit ring.
+ * @note Returns before the frame has left, Uart2SetBaud() waits for it to drain.
+ * @param msg_class: UBX class.
+ * @param msg_id: UBX id.
+ * @param payload: Payload bytes.
+ * @param len: Payload length, at most UBX_MAX_PAYLOAD.
+ */
+static void ubx_send(uint8_t msg_class, uint8_t msg_id, const uint8_t *payload, uint8_t len)
+{
+    uint8_t frame[UBX_MAX_PAYLOAD + UBX_FRAME_OVERHEAD];
+    uint8_t ck_a = 0;
+    uint8_t ck_b = 0;
+    uint8_t n = 0;
+
+    frame[n++] = UBX_SYNC1;
+    frame[n++] = UBX_SYNC2;
+    frame[n++] = msg_class;
+    frame[n++] = msg_id;
+    frame[n++] = len;
+    frame[n++] = 0;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        frame[n++] = payload[i];
+    }
+
+    // 8 bit Fletcher checksum over class, id, length and payload
+    for (uint8_t i = 2; i < n; i++)
+    {
+        ck_a += frame[i];
+        ck_b += ck_a;
+    }
+    frame[n++] = ck_a;
+    frame[n++] = ck_b;
+
+    UART2_SendBuffer(frame, n);
+}
+
+/**
+ * @brief Sends a CFG command and waits for its acknowledgement.
+ * @param msg_id: CFG message id.
+ * @param payload: Payload bytes.
+ * @param len: Payload length.
+ * @return GPS_CFG_OK, GPS_CFG_NAK or GPS_CFG_TIMEOUT after GPS_CFG_RETRIES attempts.
+ */
+static GPSCFGSTATUS ubx_command(uint8_t msg_id, const uint8_t *payload, uint8_t len)
+{
+    for (uint8_t attempt = 0; attempt < GPS_CFG_RETRIES; attempt++)
+    {
+        uint64_t started;
+
+        ack_class = UBX_CLASS_CFG;
+        ack_id = msg_id;
+        ack_state = ACK_SYNC1;
+        ack_received = 0;
+        gps_config_listening = 1;
+
+        ubx_send(UBX_CLASS_CFG, msg_id, payload, len);
+
+        started = get_ticks();
+        while (ack_received == 0 && (get_ticks() - started) < GPS_CFG_ACK_TIMEOUT_MS);
+        gps_config_listening = 0;
+
+        if (ack_received == 1)
+        {
+            return GPS_CFG_OK;
+        }
+        if (ack_received == 2)
+        {
+            return GPS_CFG_NAK;
+        }
+    }
+    return GPS_CFG_TIMEOUT;
+}
+
+/**
+ * @brief Sets the output rate of one NMEA sentence on the current port.
+ * @param type: Sentence type.
+ * @param rate: Output every n-th navigation solution, 0 disables the sentence.
+ * @return Command status.
+ */
+static GPSCFGSTATUS gps_set_nmea_rate(NMEATYPE type, uint8_t rate)
+{
+    uint8_t payload[3] = { UBX_CLASS_NMEA, ubx_nmea_id[type], rate };
+
+    return ubx_command(UBX_ID_CFG_MSG, payload, sizeof(payload));
+}
+
+/**
+ * @brief Stores a little-endian value into a payload.
+ * @param dst: First payload byte.
+ * @param value: Value to store.
+ * @param bytes: Field width.
+ */
+static void put_le(uint8_t *dst, uint32_t value, uint8_t bytes)
+{
+    for (uint8_t i = 0; i < bytes; i++)
+    {
+        dst[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Finds the baud rate the receiver currently uses and sets USART2 to match.
+ * @note A CFG-MSG for GGA at rate 1 is harmless and answered at any baud rate.
+ * @param preferred: Rate tried first.
+ * @param found: Rate the receiver answered at, left alone if it never did.
+ * @return GPS_CFG_OK once the receiver answers, GPS_CFG_TIMEOUT otherwise.
+ */
+static GPSCFGSTATUS gps_find_baud(uint32_t preferred, uint32_t *found)
+{
+    Uart2SetBaud(preferred);
+    if (gps_set_nmea_rate(NMEA_GGA, 1) == GPS_CFG_OK)
+    {
+        *found = preferred;
+        return GPS_CFG_OK;
+    }
+    for (uint8_t i = 0; i < sizeof(gps_probe_baud) / sizeof(gps_probe_baud[0]); i++)
+    {
+        if (gps_probe_baud[i] == preferred)
+        {
+            continue;
+        }
+        Uart2SetBaud(gps_probe_baud[i]);
+        if (gps_set_nmea_rate(NMEA_GGA, 1) == GPS_CFG_OK)
+        {
+            *found = gps_probe_baud[i];
+            return GPS_CFG_OK;
+        }
+    }
+    return GPS_CFG_TIMEOUT;
+}
+
+/**
+ * @brief Sends the NMEA sentence selection and the navigation rate.
+ * @param cfg: Settings to apply.
+ * @return GPS_CFG_OK if every command was acknowledged.
+ */
+static GPSCFGSTATUS gps_apply_rates(const GPSCONFIG *cfg)
+{
+    uint8_t payload[6] = {0};
+    GPSCFGSTATUS status;
+
+    // NMEA sentence selection, the first acknowledged one proves the new baud rate
+    for (uint8_t type = NMEA_GGA; type < NMEA_TYPE_COUNT; type++)
+    {
+        status = gps_set_nmea_rate((NMEATYPE)type, cfg->nmea_rate[type]);
+        if (status != GPS_CFG_OK)
+        {
+            return status;
+        }
+    }
+
+    // CFG-RATE: measurement period, one solution per measurement, aligned to GPS time
+    put_le(&payload[0], cfg->meas_period_ms, 2);
+    put_le(&payload[2], 1, 2);
+    put_le(&payload[4], 1, 2);
+    return ubx_command(UBX_ID_CFG_RATE, payload, sizeof(payload));
+}
+
+/**
+ * @brief Applies baud rate, navigation rate and NMEA output selection to the receiver.
+ * @note Blocking, meant for start-up before the main loop. Needs SysTick and Uart2Config().
+ *       On failure USART2 is left at the rate the receiver answers at, so NMEA keeps
+ *       flowing with whatever output the receiver already had.
+ * @param cfg: Settings to apply.
+ * @return GPS_CFG_OK if every command was acknowledged.
+ */
+GPSCFGSTATUS GPS_configure(const GPSCONFIG *cfg)
+{
+    uint8_t payload[UBX_MAX_PAYLOAD] = {0};
+    uint32_t answered = UART2_DEFAULT_BAUD;
+    GPSCFGSTATUS status;
+
+    status = gps_find_baud(cfg->baud, &answered);
+    if (status != GPS_CFG_OK)
+    {
+        Uart2SetBaud(UART2_DEFAULT_BAUD);
+        return status;
+    }
+
+    // CFG-PRT: UART1, 8N1, UBX+NMEA in and out at the new baud rate.
+    // The receiver acknowledges at the old rate, possibly not at all, so the
+    // new rate is confirmed by the next command instead.
+    put_le(&payload[0], UBX_PORT_UART1, 1);
+    put_le(&payload[4], UBX_MODE_8N1, 4);
+    put_le(&payload[8], cfg->baud, 4);
+    put_le(&payload[12], UBX_PROTO_UBX_NMEA, 2);
+    put_le(&payload[14], UBX_PROTO_UBX_NMEA, 2);
+    ubx_send(UBX_CLASS_CFG, UBX_ID_CFG_PRT, payload, 20);
+    delay_ms_systick(GPS_BAUD_SETTLE_MS);
+    Uart2SetBaud(cfg->baud);
+
+    status = gps_apply_rates(cfg);
+    if (status == GPS_CFG_TIMEOUT)
+    {
+        // The receiver may have kept its old rate, look for it again
+        if (gps_find_baud(cfg->baud, &answered) != GPS_CFG_OK)
+        {
+            Uart2SetBaud(answered);
+        }
+    }
+    return status;
+}
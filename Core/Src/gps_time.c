@@ -0,0 +1,194 @@
+/**
+ * @file gps_time.c
+ * @brief UTC time service disciplined by GPS time and date, extrapolated with SysTick.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Every GGA/RMC fix re-anchors UTC (Unix milliseconds) to the SysTick count
+ * at which the sentence started arriving. Between fixes the current time is the
+ * anchor plus the ticks elapsed since, so a timestamp costs one subtraction and
+ * one addition. The anchor lags true GPS time by the receiver output latency
+ * (tens of ms), which is fine for log ordering and file dates. Used from the
+ * main loop only.
+ * @credit days_from_civil() and civil_from_days() follow Howard Hinnant's
+ * public domain date algorithms.
+ * @link http://howardhinnant.github.io/date_algorithms.html
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "systick.h"
+#include "ffconf.h"
+#include "gps_time.h"
+
+/**
+ * User defined Macros
+ */
+#define MS_PER_DAY		(86400000L)
+#define MS_PER_HALF_DAY	(43200000L)
+
+/**
+ * User defined variables
+ */
+static int32_t time_days = -1;         // days since 1970-01-01 of the last RMC date, -1 if unknown
+static int32_t time_last_tod = -1;     // time of day of the last anchor, for midnight roll-over
+static uint64_t time_anchor_ms = 0;    // UTC at time_anchor_tick
+static uint32_t time_anchor_tick = 0;
+static uint8_t time_is_valid = 0;
+
+/**
+ * @brief Days since 1970-01-01 for a proleptic Gregorian date.
+ * @param y: Year.
+ * @param m: Month 1..12.
+ * @param d: Day 1..31.
+ * @return Day number.
+ */
+static int32_t days_from_civil(int32_t y, int32_t m, int32_t d)
+{
+    int32_t era, yoe, doy, doe;
+
+    y -= (m <= 2);
+    era = (y >= 0 ? y : y - 399) / 400;
+    yoe = y - era * 400;
+    doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Proleptic Gregorian date for a day number.
+ * @param z: Days since 1970-01-01.
+ * @param out: Year, month and day are written.
+ */
+static void civil_from_days(int32_t z, GPSDATETIME *out)
+{
+    int32_t era, doe, yoe, y, doy, mp, d, m;
+
+    z += 719468;
+    era = (z >= 0 ? z : z - 146096) / 146097;
+    doe = z - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    y = yoe + era * 400;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp + (mp < 10 ? 3 : -9);
+
+    out->year = (uint16_t)(y + (m <= 2));
+    out->month = (uint8_t)m;
+    out->day = (uint8_t)d;
+}
+
+/**
+ * @brief Sets the UTC date, from an RMC sentence.
+ * @param year: Two or four digit year.
+ * @param month: 1..12.
+ * @param day: 1..31.
+ */
+void gps_time_set_date(int year, int month, int day)
+{
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+    {
+        return;
+    }
+    if (year < 100)
+    {
+        year += 2000;
+    }
+    time_days = days_from_civil(year, month, day);
+    time_last_tod = -1;   // the date belongs to the time of day that follows, no rollover against older ones
+}
+
+/**
+ * @brief Re-anchors UTC to a received time of day.
+ * @note Ignored until a date is known. A time of day far below the previous one
+ *       means midnight passed before the next RMC date arrived. A new date clears
+ *       the previous time of day, so the RMC that carries it is not counted twice.
+ * @param tod_ms: UTC milliseconds since midnight, negative if the field was invalid.
+ * @param rx_tick: SysTick count at which the sentence was received.
+ */
+void gps_time_set_tod(int32_t tod_ms, uint32_t rx_tick)
+{
+    if (tod_ms < 0 || tod_ms >= MS_PER_DAY || time_days < 0)
+    {
+        return;
+    }
+    if (time_last_tod >= 0 && tod_ms + MS_PER_HALF_DAY < time_last_tod)
+    {
+        time_days++;
+    }
+    time_last_tod = tod_ms;
+
+    time_anchor_ms = (uint64_t)time_days * MS_PER_DAY + (uint64_t)tod_ms;
+    time_anchor_tick = rx_tick;
+    time_is_valid = 1;
+}
+
+/**
+ * @brief Whether UTC has been received since start-up.
+ * @return 1 if gps_time_now_ms() is meaningful.
+ */
+uint8_t gps_time_valid(void)
+{
+    return time_is_valid;
+}
+
+/**
+ * @brief Current UTC time.
+ * @return Milliseconds since 1970-01-01 00:00 UTC, 0 before the first fix.
+ */
+uint64_t gps_time_now_ms(void)
+{
+    if (!time_is_valid)
+    {
+        return 0;
+    }
+    return time_anchor_ms + (uint32_t)((uint32_t)get_ticks() - time_anchor_tick);
+}
+
+/**
+ * @brief Splits a UTC timestamp into calendar fields.
+ * @param utc_ms: Milliseconds since 1970-01-01 00:00 UTC.
+ * @param offset_min: Offset added first, GPS_UTC_OFFSET_MIN for local time, 0 for UTC.
+ * @param out: Broken-down time.
+ */
+void gps_time_to_civil(uint64_t utc_ms, int32_t offset_min, GPSDATETIME *out)
+{
+    int64_t t = (int64_t)utc_ms + (int64_t)offset_min * 60000;
+    int32_t days = (int32_t)(t / MS_PER_DAY);
+    int32_t tod = (int32_t)(t % MS_PER_DAY);
+
+    if (tod < 0)
+    {
+        tod += MS_PER_DAY;
+        days--;
+    }
+    civil_from_days(days, out);
+    out->hour = (uint8_t)(tod / 3600000);
+    out->min = (uint8_t)((tod / 60000) % 60);
+    out->sec = (uint8_t)((tod / 1000) % 60);
+    out->msec = (uint16_t)(tod % 1000);
+}
+
+/**
+ * @brief Current local time packed for FatFs.
+ * @return bit31:25 year-1980, 24:21 month, 20:16 day, 15:11 hour, 10:5 minute, 4:0 second/2.
+ *         The _NORTC_* date from ffconf.h until the first fix.
+ */
+uint32_t gps_time_fattime(void)
+{
+    GPSDATETIME now;
+
+    if (!time_is_valid)
+    {
+        return ((uint32_t)(_NORTC_YEAR - 1980) << 25) | ((uint32_t)_NORTC_MON << 21) | ((uint32_t)_NORTC_MDAY << 16);
+    }
+    gps_time_to_civil(gps_time_now_ms(), GPS_UTC_OFFSET_MIN, &now);
+    return ((uint32_t)(now.year - 1980) << 25) | ((uint32_t)now.month << 21) | ((uint32_t)now.day << 16) |
+           ((uint32_t)now.hour << 11) | ((uint32_t)now.min << 5) | ((uint32_t)now.sec >> 1);
+}
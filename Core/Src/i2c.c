@@ -6,14 +6,160 @@
  * @credit Thanks to ControllersTech for the informative tutorial on I2C using STM32 family.
  * @leveraged code The I2C functions were adapted off the below link.
  * @link: https://www.youtube.com/watch?v=xxphp9wDnHA&ab_channel=ControllersTech
+ * @note Transfers run from the I2C3 event/error interrupts, reads of two bytes or
+ * more are received by DMA1 Stream2 Channel3 with LAST set so the hardware NACKs
+ * the final byte. Register accesses are queued and the caller carries on, a
+ * callback or I2C_Wait() tells when the data is there.
+ * Every transaction has a DWT cycle deadline scaled from its length and the SCL
+ * rate, checked by I2C_Service(). A timeout, bus error or a STOP that never
+ * completes releases the bus with nine SCL pulses and a STOP, then resets the
+ * peripheral, so a sensor access takes at most its deadline plus one recovery.
  */
 
 /**
  * Default Libraries allowed to be used and user defined libraries
  */
 #include "main.h"
+#include "cycle_counter.h"
 #include "i2c.h"
 
+/**
+ * @brief Transfer phase, advanced by the I2C3 event interrupt.
+ */
+typedef enum {
+	I2C_PHASE_IDLE = 0,
+	I2C_PHASE_START,      /**< START sent, address for write next. */
+	I2C_PHASE_REG,        /**< Address acknowledged, register byte sent. */
+	I2C_PHASE_DATA,       /**< Data byte of a register write sent. */
+	I2C_PHASE_RESTART,    /**< Repeated START sent, address for read next. */
+	I2C_PHASE_RECEIVE,    /**< Data arriving by DMA or RXNE. */
+} I2CPHASE;
+
+/**
+ * @brief One queued register access.
+ */
+typedef struct {
+	uint8_t address;      /**< 8-bit write address. */
+	uint8_t reg;          /**< Register to write or to start reading from. */
+	uint8_t data;         /**< Value for a register write. */
+	uint8_t read;         /**< 1 for a register read. */
+	uint8_t *buffer;      /**< Destination of a read. */
+	uint16_t size;        /**< Bytes to read. */
+	I2CCALLBACK done;     /**< Called on completion, may be NULL. */
+	void *ctx;
+} I2CXFER;
+
+/**
+ * Transaction ring, the main loop and completion callbacks append at xfer_head
+ * with the I2C3 interrupts masked, the interrupt retires entries at xfer_tail.
+ */
+static I2CXFER xfer_queue[I2C3_QUEUE_LEN];
+static volatile uint32_t xfer_head = 0;
+static volatile uint32_t xfer_tail = 0;
+static volatile I2CPHASE xfer_phase = I2C_PHASE_IDLE;
+static volatile I2CSTATUS xfer_last_status = I2C_OK;
+static volatile uint32_t xfer_start_cycles = 0;   // CYCLE_COUNTER() at START of the current transaction
+static uint32_t xfer_byte_cycles = 0;             // core cycles per byte (9 SCL periods)
+static I2CSTATS i2c_stats;
+
+#if (I2C3_QUEUE_LEN & (I2C3_QUEUE_LEN - 1)) != 0
+#error "I2C3_QUEUE_LEN must be a power of two"
+#endif
+
+/**
+ * @brief Resets I2C3 and programs timing, interrupts and enable.
+ * @note Also the last step of a bus recovery.
+ * @param None
+ * @return None
+ */
+static void i2c3_periph_init (void)
+{
+	I2CTIMING timing;
+
+	// Reset the I2C3 using SWRESET
+	I2C3->CR1 |= I2C3_SWRESET_SET;
+	I2C3->CR1 &= ~(I2C3_SWRESET_SET);
+
+	// Timing from the actual APB1 clock, falling back to standard mode if it is too slow for fast mode
+	if (!I2C_Timing(HAL_RCC_GetPCLK1Freq(), I2C3_SPEED_HZ, I2C3_FAST_DUTY, &timing))
+	{
+		I2C_Timing(HAL_RCC_GetPCLK1Freq(), I2C_STANDARD_MAX_HZ, I2C3_FAST_DUTY, &timing);
+	}
+	I2C3->CR2 = (I2C3->CR2 & ~I2C_CR2_FREQ) | timing.freq;
+	I2C3->CCR = timing.ccr;
+	I2C3->TRISE = timing.trise;
+	xfer_byte_cycles = (uint32_t)((uint64_t)SystemCoreClock * 9 / timing.scl_hz);
+
+	// Event and error interrupts drive the transfers
+	I2C3->CR2 |= ITEVTEN_BIT | ITERREN_BIT;
+
+	// Program the I2C3_CR1 register to enable the peripheral
+	I2C3->CR1 |= I2C3_ENABLE;  // Enable I2C
+}
+
+/**
+ * @brief Busy-waits on the cycle counter.
+ * @param us: Microseconds.
+ * @return None
+ */
+static void i2c3_delay_us (uint32_t us)
+{
+	uint32_t start = CYCLE_COUNTER();
+	uint32_t cycles = us * (SystemCoreClock / 1000000);
+
+	while (CYCLE_COUNTER() - start < cycles);
+}
+
+/**
+ * @brief Frees a bus held by a slave and resets the peripheral.
+ * @details A slave reset mid-read keeps driving SDA low until it has clocked out the
+ * rest of its byte. SCL is bit-banged up to nine times until SDA is released, then
+ * a STOP (SDA rising while SCL is high) resets every slave's bus state machine.
+ * @param None
+ * @return None
+ */
+static void i2c3_bus_recover (void)
+{
+	uint32_t start;
+
+	I2C3->CR1 &= ~I2C3_ENABLE;
+	DMA1_Stream2->CR &= ~DMA_SxCR_EN;
+
+	// Both lines as open-drain outputs, released
+	GPIOA->BSRR = GPIOA_PA8_PIN;
+	GPIOC->BSRR = GPIOC_PC9_PIN;
+	GPIOA->MODER = (GPIOA->MODER & ~GPIOA_PA8_MODE_MASK) | GPIOA_PA8_OUT;
+	GPIOC->MODER = (GPIOC->MODER & ~GPIOC_PC9_MODE_MASK) | GPIOC_PC9_OUT;
+	i2c3_delay_us(I2C3_RECOVERY_HALF_US);
+
+	for (uint8_t i = 0; i < I2C3_RECOVERY_CLOCKS && !(GPIOC->IDR & GPIOC_PC9_PIN); i++)
+	{
+		GPIOA->BSRR = GPIOA_PA8_PIN << 16;   // SCL low
+		i2c3_delay_us(I2C3_RECOVERY_HALF_US);
+		GPIOA->BSRR = GPIOA_PA8_PIN;         // SCL high
+		i2c3_delay_us(I2C3_RECOVERY_HALF_US);
+	}
+
+	// STOP: SDA low while SCL low, SCL high, then SDA high
+	GPIOA->BSRR = GPIOA_PA8_PIN << 16;
+	i2c3_delay_us(I2C3_RECOVERY_HALF_US);
+	GPIOC->BSRR = GPIOC_PC9_PIN << 16;
+	i2c3_delay_us(I2C3_RECOVERY_HALF_US);
+	GPIOA->BSRR = GPIOA_PA8_PIN;
+	i2c3_delay_us(I2C3_RECOVERY_HALF_US);
+	GPIOC->BSRR = GPIOC_PC9_PIN;
+	i2c3_delay_us(I2C3_RECOVERY_HALF_US);
+
+	// Back to the I2C3 alternate function
+	GPIOA->MODER = (GPIOA->MODER & ~GPIOA_PA8_MODE_MASK) | GPIOA_PA8_ALT;
+	GPIOC->MODER = (GPIOC->MODER & ~GPIOC_PC9_MODE_MASK) | GPIOC_PC9_ALT;
+
+	start = CYCLE_COUNTER();
+	while ((DMA1_Stream2->CR & DMA_SxCR_EN) && CYCLE_COUNTER() - start < xfer_byte_cycles);
+	i2c3_periph_init();
+	i2c_stats.recoveries++;
+}
+
 /**
  * @brief Configures the I2C peripheral and associated GPIO pins.
  * @details Enables the I2C CLOCK and GPIO CLOCK, configures I2C3-SDA and I2C3-SCL,
@@ -44,164 +190,369 @@ void I2C_Config (void)
 	GPIOA->PUPDR |= GPIOA_PA8_PULL_UP;
 	GPIOC->PUPDR |= GPIOC_PC9_PULL_UP;
 
-	//Alternate function select AF4 for I2C3
-	GPIOA->AFR[1] = GPIOA_PA8_AFR_I2C3;
-	GPIOC->AFR[1] = GPIOC_PC9_AFR_I2C3;
+	//Alternate function select AF4 for I2C3, the other pins of the ports keep theirs
+	GPIOA->AFR[1] = (GPIOA->AFR[1] & ~GPIOA_PA8_AFR_MASK) | GPIOA_PA8_AFR_I2C3;
+	GPIOC->AFR[1] = (GPIOC->AFR[1] & ~GPIOC_PC9_AFR_MASK) | GPIOC_PC9_AFR_I2C3;
 
+	// Transaction deadlines are measured in core cycles
+	cycle_counter_init();
 
-	// Reset the I2C3 using SWRESET
-	I2C3->CR1 |= I2C3_SWRESET_SET;
-	I2C3->CR1 &= ~(I2C3_SWRESET_SET);
-
-	///Because APB1 is @ 24Mhz, set peripheral also to 24 Mhz
-	I2C3->CR2 |= I2C3_PERIPH_FREQ;
-
-	//Calculation needed here
-	/* Configure the clock control registers:
-	 * This value is determined by taking the (SCL high time
-	 * + SDA/SCL rise time) / APB1 Bus Frequency
-	 * APB1 Bus Frequency: 24 Mhz
-	*/
-	I2C3->CCR = I2C3_CCR;
+	// Receive through DMA1 Stream2 Channel3, memory address and length are set per transfer
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+	DMA1_Stream2->CR &= ~DMA_SxCR_EN;
+	while (DMA1_Stream2->CR & DMA_SxCR_EN);          // wait for the stream to stop
+	DMA1->LIFCR = DMA_LIFCR_CTCIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTEIF2 | DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CFEIF2;
+	DMA1_Stream2->PAR = (uint32_t)&I2C3->DR;
+	DMA1_Stream2->CR = DMA_SxCR_CHSEL_1 | DMA_SxCR_CHSEL_0   // Channel 3 = I2C3_RX
+	                 | DMA_SxCR_MINC
+	                 | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
 
-	// Configure the rise time register
-	// (Rise Time SCL / Period of APB1 clock) + 1
-	I2C3->TRISE = I2C3_TRISE;
+	i2c3_periph_init();
 
-	// Program the I2C3_CR1 register to enable the peripheral
-	I2C3->CR1 |= I2C3_ENABLE;  // Enable I2C
+	NVIC_SetPriority(I2C3_EV_IRQn, I2C3_IRQ_PRIORITY);
+	NVIC_SetPriority(I2C3_ER_IRQn, I2C3_IRQ_PRIORITY);
+	NVIC_SetPriority(DMA1_Stream2_IRQn, I2C3_IRQ_PRIORITY);
+	NVIC_ClearPendingIRQ(I2C3_EV_IRQn);
+	NVIC_ClearPendingIRQ(I2C3_ER_IRQn);
+	NVIC_ClearPendingIRQ(DMA1_Stream2_IRQn);
+	NVIC_EnableIRQ(I2C3_EV_IRQn);
+	NVIC_EnableIRQ(I2C3_ER_IRQn);
+	NVIC_EnableIRQ(DMA1_Stream2_IRQn);
 }
 
 /**
- * @brief Generates the I2C start condition.
- * @details Enables ACK, generates START, and ensures the start bit is generated.
+ * @brief Generates START for the transaction at the tail of the queue, if any.
+ * @note Called with the I2C3 interrupts masked or from them.
  * @param None
  * @return None
  */
-void I2C_Start (void)
+static void i2c3_start_next (void)
 {
-	I2C3->CR1 |= ACK_ENABLE; //Acknowledge returned after a byte is received
-	I2C3->CR1 |= START_GEN;  // Generate START
-	while (!(I2C3->SR1 & START_BIT));  //Ensure start bit (condition) generated, read only
+	uint32_t start = CYCLE_COUNTER();
+	uint32_t limit = I2C3_STOP_TIMEOUT_US * (SystemCoreClock / 1000000);
+
+	if (xfer_tail == xfer_head)
+	{
+		xfer_phase = I2C_PHASE_IDLE;
+		return;
+	}
+	// The previous STOP is still on the bus, a few microseconds unless SCL is held low
+	while (I2C3->CR1 & STOP_BIT)
+	{
+		if (CYCLE_COUNTER() - start > limit)
+		{
+			i2c_stats.timeout++;
+			i2c3_bus_recover();
+			break;
+		}
+	}
+	xfer_phase = I2C_PHASE_START;
+	xfer_start_cycles = CYCLE_COUNTER();
+	I2C3->CR1 |= ACK_ENABLE | START_GEN;
+}
+
+/**
+ * @brief Deadline of the current transaction in core cycles.
+ * @param x: Transaction on the bus.
+ * @return Cycles after xfer_start_cycles.
+ */
+static uint32_t i2c3_deadline (const I2CXFER *x)
+{
+	// address + register + data, or address + register + address + size bytes
+	uint32_t bytes = x->read ? 3 + x->size : 3;
+
+	return bytes * xfer_byte_cycles * I2C3_TIMEOUT_SLACK + I2C3_TIMEOUT_MIN_US * (SystemCoreClock / 1000000);
 }
 
 /**
- * @brief Writes a byte of data on the I2C bus.
- * @details Waits for TXE and BTF bits, then transmits data.
- * @param data: Data to be transmitted.
+ * @brief Retires the current transaction, reports it and starts the next one.
+ * @param status: Outcome of the transaction.
  * @return None
  */
-void I2C_Write (uint8_t data)
+static void i2c3_finish (I2CSTATUS status)
 {
-	while (!(I2C3->SR1 & TXE_BIT));  // while TXE bit is not set, stay here
-	I2C3->DR = data;
-	while (!(I2C3->SR1 & BTF_BIT));  // while BTF bit is not set, stay here
+	I2CXFER *x = &xfer_queue[xfer_tail & (I2C3_QUEUE_LEN - 1)];
+	I2CCALLBACK done = x->done;
+	void *ctx = x->ctx;
+
+	I2C3->CR2 &= ~(ITBUFEN_BIT | DMAEN_BIT | LAST_BIT);
+	if (status != I2C_OK)
+	{
+		xfer_last_status = status;
+	}
+	xfer_tail++;
+	// The callback may queue the next step of a chain, start it in the same pass
+	if (done != NULL)
+	{
+		done(status, ctx);
+	}
+	i2c3_start_next();
 }
 
 /**
- * @brief Sends the slave address on the I2C bus.
- * @details Sends the address byte and waits for ADDR bit to be set.
- * @param Address: 7-bit slave address.
+ * @brief Abandons the current transaction, counts the failure and frees the bus.
+ * @param status: Error to report.
  * @return None
  */
-void I2C_Address (uint8_t Address)
+static void i2c3_fail (I2CSTATUS status)
+{
+	DMA1_Stream2->CR &= ~DMA_SxCR_EN;
+	switch (status)
+	{
+		case I2C_ERR_NACK:
+			i2c_stats.nack++;
+			I2C3->CR1 |= STOP_BIT;
+			break;
+		case I2C_ERR_ARLO:
+			i2c_stats.arbitration_lost++;   // the bus belongs to another master, no STOP
+			break;
+		case I2C_ERR_OVR:
+			i2c_stats.overrun++;
+			I2C3->CR1 |= STOP_BIT;
+			break;
+		case I2C_ERR_TIMEOUT:
+			i2c_stats.timeout++;
+			i2c3_bus_recover();
+			break;
+		default:
+			i2c_stats.bus_error++;
+			i2c3_bus_recover();
+			break;
+	}
+	if (xfer_phase != I2C_PHASE_IDLE)
+	{
+		i2c3_finish(status);
+	}
+}
+
+/**
+ * @brief Appends a transaction and starts the bus if it was idle.
+ * @param x: Transaction to copy into the queue.
+ * @return 1 if queued, 0 if the queue is full.
+ */
+static uint8_t i2c3_submit (const I2CXFER *x)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint8_t queued = 0;
+
+	__disable_irq();
+	if (xfer_head - xfer_tail < I2C3_QUEUE_LEN)
+	{
+		xfer_queue[xfer_head & (I2C3_QUEUE_LEN - 1)] = *x;
+		xfer_head++;
+		queued = 1;
+		if (xfer_phase == I2C_PHASE_IDLE)
+		{
+			i2c3_start_next();
+		}
+	}
+	__set_PRIMASK(primask);
+	return queued;
+}
+
+/**
+ * @brief Queues a single register write to the MPU6050 sensor.
+ * @details The value is copied, the function returns before the transfer starts.
+ * @param Address: 8-bit write address of the MPU6050 sensor.
+ * @param Reg: Register address to write data to.
+ * @param Data: Data byte to be written to the register.
+ * @return 1 if queued, 0 if the queue is full.
+ */
+uint8_t MPU_Write (uint8_t Address, uint8_t Reg, uint8_t Data)
+{
+	I2CXFER x = { .address = Address, .reg = Reg, .data = Data, .read = 0 };
+
+	return i2c3_submit(&x);
+}
+
+/**
+ * @brief Queues a register read from the MPU6050 sensor.
+ * @details Register address write, repeated START, then size bytes into buffer.
+ * The buffer must stay valid until done runs or I2C_Wait() returns.
+ * @param Address: 8-bit write address of the MPU6050 sensor.
+ * @param Reg: Register address to read data from.
+ * @param buffer: Pointer to the buffer to store the read data.
+ * @param size: Number of bytes to read, a whole FIFO (1024 bytes) fits.
+ * @param done: Completion callback, NULL to poll with I2C_Busy()/I2C_Wait().
+ * @param ctx: Passed to done.
+ * @return 1 if queued, 0 if the queue is full.
+ */
+uint8_t MPU_Read (uint8_t Address, uint8_t Reg, uint8_t *buffer, uint16_t size, I2CCALLBACK done, void *ctx)
+{
+	I2CXFER x = { .address = Address, .reg = Reg, .read = 1, .buffer = buffer, .size = size, .done = done, .ctx = ctx };
+
+	if (size == 0)
+	{
+		return 0;
+	}
+	return i2c3_submit(&x);
+}
+
+/**
+ * @brief Whether transactions are still queued or on the bus.
+ * @param None
+ * @return 1 while busy.
+ */
+uint8_t I2C_Busy (void)
 {
-	I2C3->DR = Address;  // Send address byte
-	while (!(I2C3->SR1 & ADDR_BIT));  // while ADDR bit not set
-	uint8_t temp = I2C3->SR1 | I2C3->SR2;  // read SR1 and SR2 to clear the ADDR bit
+	return xfer_phase != I2C_PHASE_IDLE;
 }
 
 /**
- * @brief Generates the I2C stop condition.
- * @details Generates the I2C stop condition.
+ * @brief Blocks until every queued transaction finished, for start-up code.
+ * @param None
+ * @return I2C_OK, or the last error seen since the previous call.
+ */
+I2CSTATUS I2C_Wait (void)
+{
+	I2CSTATUS status;
+
+	while (I2C_Busy())
+	{
+		I2C_Service();
+	}
+	status = xfer_last_status;
+	xfer_last_status = I2C_OK;
+	return status;
+}
+
+/**
+ * @brief Aborts the transaction on the bus if its deadline has passed.
+ * @note Called from the main loop and I2C_Wait().
  * @param None
  * @return None
  */
-void I2C_Stop (void)
+void I2C_Service (void)
 {
-	I2C3->CR1 |= STOP_BIT;  // Stop I2C
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (xfer_phase != I2C_PHASE_IDLE &&
+	    CYCLE_COUNTER() - xfer_start_cycles > i2c3_deadline(&xfer_queue[xfer_tail & (I2C3_QUEUE_LEN - 1)]))
+	{
+		i2c3_fail(I2C_ERR_TIMEOUT);
+	}
+	__set_PRIMASK(primask);
 }
 
 /**
- * @brief Reads data from the I2C bus.
- * @details Reads data from the I2C bus based on the specified parameters.
- * @param Address: 7-bit slave address.
- * @param buffer: Pointer to the buffer to store the read data.
- * @param size: Number of bytes to read.
+ * @brief Copies the failure counters.
+ * @param stats: Destination.
+ * @return None
+ */
+void I2C_Stats (I2CSTATS *stats)
+{
+	*stats = i2c_stats;
+}
+
+/**
+ * @brief Handles the I2C3 event interrupt: START sent, address acknowledged,
+ *        byte transferred and single byte received.
+ * @note This function is invoked by the I2C3 event interrupt.
  * @return None
  */
-void I2C_Read (uint8_t Address, uint8_t *buffer, uint8_t size)
+void i2c3_ev_call (void)
 {
-	//If only 1 BYTE needs to be Read
-	int remaining = size;
-	if (size == 1)
+	I2CXFER *x = &xfer_queue[xfer_tail & (I2C3_QUEUE_LEN - 1)];
+	uint32_t sr1 = I2C3->SR1;
+
+	if (sr1 & START_BIT)
 	{
-		I2C3->DR = Address;  // Send Address
-		while (!(I2C3->SR1 & ADDR_BIT));  // wait for ADDR bit to set
+		// SR1 read followed by DR write clears SB
+		I2C3->DR = (xfer_phase == I2C_PHASE_RESTART) ? (x->address | 0x01) : x->address;
+		return;
+	}
 
-		I2C3->CR1 &= ~ACK_ENABLE;  // clear the ACK bit
-		uint8_t temp = I2C3->SR1 | I2C3->SR2;  // Clear ADDR by reading SR1 and SR2
-		I2C3->CR1 |= STOP_BIT;  // Stop I2C
-		while (!(I2C3->SR1 & RXNE_BIT));  // Ensure RxNE is set
-		buffer[size-remaining] = I2C3->DR;  // Read data and store into buffer
+	if (sr1 & ADDR_BIT)
+	{
+		if (xfer_phase != I2C_PHASE_RESTART)
+		{
+			(void)I2C3->SR2;              // SR1 then SR2 read clears ADDR
+			I2C3->DR = x->reg;
+			xfer_phase = I2C_PHASE_REG;
+		}
+		else if (x->size == 1)
+		{
+			// NACK and STOP have to be armed before ADDR is cleared
+			I2C3->CR1 &= ~ACK_ENABLE;
+			(void)I2C3->SR2;
+			I2C3->CR1 |= STOP_BIT;
+			I2C3->CR2 |= ITBUFEN_BIT;
+			xfer_phase = I2C_PHASE_RECEIVE;
+		}
+		else
+		{
+			DMA1->LIFCR = DMA_LIFCR_CTCIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTEIF2 | DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CFEIF2;
+			DMA1_Stream2->M0AR = (uint32_t)x->buffer;
+			DMA1_Stream2->NDTR = x->size;
+			DMA1_Stream2->CR |= DMA_SxCR_EN;
+			I2C3->CR2 |= DMAEN_BIT | LAST_BIT;   // hardware NACKs the last byte
+			(void)I2C3->SR2;
+			xfer_phase = I2C_PHASE_RECEIVE;
+		}
+		return;
 	}
-	//If Multiple BYTES needs to be read
-	else
+
+	if ((sr1 & RXNE_BIT) && xfer_phase == I2C_PHASE_RECEIVE)
 	{
-		I2C3->DR = Address;  // Send Address
-		while (!(I2C3->SR1 & ADDR_BIT));  // wait for ADDR bit to set
-		uint8_t temp = I2C3->SR1 | I2C3->SR2;  // read SR1 and SR2 to clear the ADDR bit
+		x->buffer[0] = I2C3->DR;
+		i2c3_finish(I2C_OK);
+		return;
+	}
 
-		while (remaining > 2)
+	if (sr1 & BTF_BIT)
+	{
+		if (xfer_phase == I2C_PHASE_REG && x->read)
 		{
-			while (!(I2C3->SR1 & RXNE_BIT));  // wait for RxNE to set
-			buffer[size-remaining] = I2C3->DR;  // Store data from DR into buffer
-			I2C3->CR1 |= ACK_ENABLE;  // Send ACK
-			remaining--;
+			xfer_phase = I2C_PHASE_RESTART;
+			I2C3->CR1 |= START_GEN;       // repeated START clears BTF
+		}
+		else if (xfer_phase == I2C_PHASE_REG)
+		{
+			I2C3->DR = x->data;
+			xfer_phase = I2C_PHASE_DATA;
+		}
+		else if (xfer_phase == I2C_PHASE_DATA)
+		{
+			I2C3->CR1 |= STOP_BIT;        // STOP clears BTF
+			i2c3_finish(I2C_OK);
 		}
-		while (!(I2C3->SR1 & RXNE_BIT));  // wait for RxNE to set
-		buffer[size-remaining] = I2C3->DR;
-		I2C3->CR1 &= ~ACK_ENABLE;  // Clear ACK
-		I2C3->CR1 |= STOP_BIT;  // Stop I2C
-		remaining--;
-		while (!(I2C3->SR1 & RXNE_BIT));  // wait for RxNE to set
-		buffer[size-remaining] = I2C3->DR;  // copy the data into the buffer
 	}
 }
 
 /**
- * @brief Writes data to the MPU6050 sensor.
- * @details Initiates communication with the MPU6050 sensor and writes data to the specified register.
- * @param Address: 7-bit slave address of the MPU6050 sensor.
- * @param Reg: Register address to write data to.
- * @param Data: Data byte to be written to the register.
+ * @brief Handles the I2C3 error interrupt, the transaction is abandoned.
+ * @note This function is invoked by the I2C3 error interrupt.
  * @return None
  */
-void MPU_Write (uint8_t Address, uint8_t Reg, uint8_t Data)
+void i2c3_er_call (void)
 {
-	I2C_Start();
-	I2C_Address (Address);
-	I2C_Write (Reg);
-	I2C_Write (Data);
-	I2C_Stop ();
+	uint32_t sr1 = I2C3->SR1;
+	I2CSTATUS status = (sr1 & BERR_BIT) ? I2C_ERR_BUS :
+	                   (sr1 & ARLO_BIT) ? I2C_ERR_ARLO :
+	                   (sr1 & AF_BIT) ? I2C_ERR_NACK : I2C_ERR_OVR;
+
+	I2C3->SR1 = ~(BERR_BIT | ARLO_BIT | AF_BIT | OVR_BIT) & 0xFFFF;   // error flags clear on writing 0
+	i2c3_fail(status);
 }
 
 /**
- * @brief Reads data from the MPU6050 sensor.
- * @details Initiates communication with the MPU6050 sensor, writes the register address,
- * generates a repeated start condition, and reads the specified number of bytes.
- * @param Address: 7-bit slave address of the MPU6050 sensor.
- * @param Reg: Register address to read data from.
- * @param buffer: Pointer to the buffer to store the read data.
- * @param size: Number of bytes to read.
+ * @brief Handles the DMA1 Stream2 interrupt, fired when a multi-byte read has been received.
+ * @note This function is invoked by the DMA1 Stream2 interrupt.
  * @return None
  */
-void MPU_Read (uint8_t Address, uint8_t Reg, uint8_t *buffer, uint8_t size)
+void dma1_stream2_call (void)
 {
-	I2C_Start ();
-	I2C_Address (Address);
-	I2C_Write (Reg);
-	I2C_Start ();
-	I2C_Read (Address+0x01, buffer, size);
-	I2C_Stop ();
+	if (DMA1->LISR & DMA_LISR_TCIF2)
+	{
+		DMA1->LIFCR = DMA_LIFCR_CTCIF2;
+		I2C3->CR1 |= STOP_BIT;
+		i2c3_finish(I2C_OK);
+	}
+
+	if (DMA1->LISR & DMA_LISR_TEIF2)
+	{
+		DMA1->LIFCR = DMA_LIFCR_CTEIF2;
+		i2c3_fail(I2C_ERR_OVR);
+	}
 }
@@ -0,0 +1,71 @@
+/**
+ * @file i2c_timing.c
+ * @brief I2C clock control register values for a bus clock and SCL speed.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Kept apart from the I2C3 driver because it touches no peripheral, so the
+ * host tests in Tests/ can check it against the reference manual formulas.
+ */
+
+/**
+ * Default Libraries allowed to be used and user defined libraries
+ */
+#include <stdint.h>
+#include "i2c.h"
+
+/**
+ * @brief Computes the I2C timing registers for a bus clock and SCL speed (RM0090 27.6.8, 27.6.9).
+ * @details Standard mode: Thigh = Tlow = CCR * Tpclk1, CCR >= 4, rise time 1000 ns.
+ * Fast mode duty 2: Thigh = CCR * Tpclk1, Tlow = 2 * Thigh. Duty 16/9: Thigh = 9 * CCR * Tpclk1,
+ * Tlow = 16 * CCR * Tpclk1. CCR >= 1, rise time 300 ns. CCR is rounded up so SCL never
+ * exceeds the requested speed.
+ * @param pclk1: APB1 clock in Hz.
+ * @param speed: Wanted SCL frequency in Hz, above 100 kHz selects fast mode.
+ * @param duty: Fast mode duty cycle, ignored in standard mode.
+ * @param timing: Register values and the SCL frequency obtained.
+ * @return 1 on success, 0 if the clock is outside what the mode allows (2-50 MHz, 4 MHz for fast mode).
+ */
+uint8_t I2C_Timing (uint32_t pclk1, uint32_t speed, I2CDUTY duty, I2CTIMING *timing)
+{
+	uint32_t freq = pclk1 / 1000000;
+	uint32_t div, ccr;
+
+	if (speed == 0 || speed > I2C_FAST_MAX_HZ || freq < 2 || freq > 50)
+	{
+		return 0;
+	}
+
+	if (speed <= I2C_STANDARD_MAX_HZ)
+	{
+		div = 2;
+		ccr = (pclk1 + div * speed - 1) / (div * speed);
+		if (ccr < 4)
+		{
+			ccr = 4;
+		}
+		timing->ccr = (uint16_t)ccr;
+		timing->trise = (uint16_t)(freq + 1);
+	}
+	else
+	{
+		if (freq < 4)
+		{
+			return 0;
+		}
+		div = (duty == I2C_DUTY_16_9) ? 25 : 3;
+		ccr = (pclk1 + div * speed - 1) / (div * speed);
+		if (ccr < 1)
+		{
+			ccr = 1;
+		}
+		timing->ccr = (uint16_t)(ccr | CCR_FS_BIT | ((duty == I2C_DUTY_16_9) ? CCR_DUTY_BIT : 0));
+		timing->trise = (uint16_t)(freq * 300 / 1000 + 1);
+	}
+	if (ccr > 0xFFF)
+	{
+		return 0;
+	}
+	timing->freq = (uint16_t)freq;
+	timing->scl_hz = pclk1 / (div * ccr);
+	return 1;
+}
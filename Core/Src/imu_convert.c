@@ -0,0 +1,110 @@
+/**
+ * @file imu_convert.c
+ * @brief Fixed-point conversion of raw MPU6050 counts to calibrated engineering units.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Samples stay raw int16 through acquisition and windowing. Conversion happens
+ * only when a consumer asks, as one subtraction and one 32x32->64 multiply per axis.
+ * The unit per LSB comes from the full-scale selection in ACCEL_CONFIG/GYRO_CONFIG
+ * as a Q16 factor, the calibration gain trims it in Q15, and both are folded into a
+ * single Q16 multiplier whenever either changes.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "imu_convert.h"
+
+/**
+ * User defined Macros
+ */
+#define ACCEL_LSB_PER_G_FS0		(16384)	// +-2 g, halves with every AFS_SEL step
+#define IMU_Q16_HALF			(1 << 15)	// rounds Q16 products to nearest
+
+/**
+ * User defined variables
+ */
+static const uint16_t gyro_lsb_x10[4] = { 1310, 655, 328, 164 };  // LSB per deg/s * 10, datasheet FS_SEL 0..3
+
+static int32_t accel_unit_q16 = 0;        // mg per LSB in Q16
+static int32_t gyro_unit_q16 = 0;         // mdps per LSB in Q16
+static IMUCAL imu_cal = {
+    .accel_gain = { IMU_Q15_ONE, IMU_Q15_ONE, IMU_Q15_ONE },
+    .gyro_gain = { IMU_Q15_ONE, IMU_Q15_ONE, IMU_Q15_ONE },
+};
+static int32_t accel_k_q16[IMU_AXES];     // unit * gain, Q16
+static int32_t gyro_k_q16[IMU_AXES];
+
+/**
+ * @brief Folds the range factors and the calibration gains into one multiplier per axis.
+ */
+static void imu_convert_update(void)
+{
+    for (uint8_t i = 0; i < IMU_AXES; i++)
+    {
+        accel_k_q16[i] = (int32_t)(((int64_t)accel_unit_q16 * imu_cal.accel_gain[i]) >> 15);
+        gyro_k_q16[i] = (int32_t)(((int64_t)gyro_unit_q16 * imu_cal.gyro_gain[i]) >> 15);
+    }
+}
+
+/**
+ * @brief Derives the unit factors from the full-scale selections.
+ * @param accel_fs_sel: AFS_SEL field of ACCEL_CONFIG (0..3 for +-2/4/8/16 g).
+ * @param gyro_fs_sel: FS_SEL field of GYRO_CONFIG (0..3 for +-250/500/1000/2000 deg/s).
+ */
+void imu_convert_init(uint8_t accel_fs_sel, uint8_t gyro_fs_sel)
+{
+    uint32_t accel_lsb = ACCEL_LSB_PER_G_FS0 >> (accel_fs_sel & 3);
+
+    // 1000 mg per g over LSB per g, 2048 LSB/g at +-16 g gives exactly 32000
+    accel_unit_q16 = (int32_t)((1000UL << 16) / accel_lsb);
+    // 1000 mdps per deg/s over LSB per deg/s, the datasheet gives the latter to 0.1
+    gyro_unit_q16 = (int32_t)(((uint64_t)10000 << 16) / gyro_lsb_x10[gyro_fs_sel & 3]);
+    imu_convert_update();
+}
+
+/**
+ * @brief Installs offsets and gain trims.
+ * @param cal: Calibration, copied.
+ */
+void imu_convert_calibrate(const IMUCAL *cal)
+{
+    imu_cal = *cal;
+    imu_convert_update();
+}
+
+/**
+ * @brief Reads back the calibration in use, so one part of it can be changed.
+ * @param cal: Destination.
+ */
+void imu_convert_calibration(IMUCAL *cal)
+{
+    *cal = imu_cal;
+}
+
+/**
+ * @brief Converts one raw accelerometer reading.
+ * @param raw: Raw counts.
+ * @param axis: 0 = X, 1 = Y, 2 = Z.
+ * @return Milli-g.
+ */
+int32_t imu_accel_mg(int16_t raw, uint8_t axis)
+{
+    return (int32_t)(((int64_t)(raw - imu_cal.accel_offset[axis]) * accel_k_q16[axis] + IMU_Q16_HALF) >> 16);
+}
+
+/**
+ * @brief Converts one raw gyroscope reading.
+ * @param raw: Raw counts.
+ * @param axis: 0 = X, 1 = Y, 2 = Z.
+ * @return Milli-degrees per second.
+ */
+int32_t imu_gyro_mdps(int16_t raw, uint8_t axis)
+{
+    return (int32_t)(((int64_t)(raw - imu_cal.gyro_offset[axis]) * gyro_k_q16[axis] + IMU_Q16_HALF) >> 16);
+}
@@ -0,0 +1,151 @@
+/**
+ * @file imu_filter.c
+ * @brief Per-axis accelerometer filter and decimation pipeline, 1 kHz -> 100 Hz -> 10 Hz.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Per axis, every 1 kHz sample goes through a 4th order 25 Hz low-pass and a /10
+ * decimator. Each kept 100 Hz sample goes through a 4th order 3 Hz low-pass and a
+ * second /10 decimator for the 10 Hz stream. Only the first stage runs at the full
+ * rate, about a tenth of the 100 Hz work is added on top. Gravity is not filtered
+ * out here, the attitude estimate removes it when rotating into the vehicle frame.
+ * Raw samples at 1 kHz stay available from the imu_ring for consumers that need
+ * them. The cascades are primed with the first sample, so the streams start
+ * settled instead of ringing from zero to 1 g.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "imu_filter.h"
+#include "biquad.h"
+#include "filter_coeffs.h"
+
+/**
+ * User defined Macros
+ */
+#define SECTIONS(c)		((uint8_t)(sizeof(c) / sizeof((c)[0])))
+
+/**
+ * User defined variables
+ */
+static BIQUADSTATE aa_1k_state[3][SECTIONS(filter_aa_1k)];
+static BIQUADSTATE aa_100_state[3][SECTIONS(filter_aa_100)];
+static DECIMATOR decim_100 = { IMU_FILTER_DECIM, 0 };
+static DECIMATOR decim_10 = { IMU_FILTER_DECIM, 0 };
+static uint8_t primed = 0;
+
+/**
+ * @brief Restarts the pipeline, the next sample primes every stage.
+ */
+void imu_filter_init(void)
+{
+    decim_100.phase = 0;
+    decim_10.phase = 0;
+    primed = 0;
+}
+
+/**
+ * @brief Feeds one 1 kHz sample through the pipeline.
+ * @param f: Sample.
+ * @param out: Receives the streams that were updated, others are left untouched.
+ * @return IMU_STREAM_* flags of the updated streams, 0 for most samples.
+ */
+uint8_t imu_filter_push(const IMUFRAME *f, IMUFILTEROUT *out)
+{
+    const int16_t *raw = &f->ax;   // ax, ay, az are contiguous
+    int32_t x[3];
+    uint8_t streams = 0;
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        x[axis] = BIQUAD_FROM_RAW(raw[axis]);
+        if (!primed)
+        {
+            biquad_prime(filter_aa_1k, aa_1k_state[axis], SECTIONS(filter_aa_1k), x[axis]);
+            biquad_prime(filter_aa_100, aa_100_state[axis], SECTIONS(filter_aa_100), x[axis]);
+        }
+        x[axis] = biquad_run(filter_aa_1k, aa_1k_state[axis], SECTIONS(filter_aa_1k), x[axis]);
+    }
+    primed = 1;
+
+    if (!decimator_step(&decim_100))
+    {
+        return 0;
+    }
+    out->t_us = f->t_us;
+    streams = IMU_STREAM_100HZ;
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        out->lp100[axis] = BIQUAD_TO_RAW(x[axis]);
+        x[axis] = biquad_run(filter_aa_100, aa_100_state[axis], SECTIONS(filter_aa_100), x[axis]);
+    }
+
+    if (decimator_step(&decim_10))
+    {
+        streams |= IMU_STREAM_10HZ;
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            out->lp10[axis] = BIQUAD_TO_RAW(x[axis]);
+        }
+    }
+    return streams;
+}
+
+#ifdef FILTER_BENCHMARK
+#include "cycle_counter.h"
+
+/**
+ * User defined Macros
+ */
+#define BENCH_SAMPLES	(1000)	// one second at the 1 kHz sample rate
+
+/**
+ * @brief Measures the cycles of one biquad section, one decimator step and the whole pipeline.
+ * @note Build with -DFILTER_BENCHMARK, call once after start-up and read the result in the debugger.
+ *       The pipeline is restarted afterwards.
+ * @param result: Average cycles.
+ */
+void imu_filter_benchmark(IMUFILTERBENCH *result)
+{
+    static IMUFRAME frame;
+    IMUFILTEROUT out;
+    BIQUADSTATE state[SECTIONS(filter_aa_1k)];
+    DECIMATOR d = { IMU_FILTER_DECIM, 0 };
+    volatile int32_t sink = 0;
+    uint32_t start;
+
+    cycle_counter_init();
+    biquad_prime(filter_aa_1k, state, SECTIONS(filter_aa_1k), 0);
+    start = CYCLE_COUNTER();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        sink = biquad_run(filter_aa_1k, state, SECTIONS(filter_aa_1k), BIQUAD_FROM_RAW((int16_t)(i * 37)));
+    }
+    result->section_cycles = (CYCLE_COUNTER() - start) / (BENCH_SAMPLES * SECTIONS(filter_aa_1k));
+
+    start = CYCLE_COUNTER();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        sink = decimator_step(&d);
+    }
+    result->decimator_cycles = (CYCLE_COUNTER() - start) / BENCH_SAMPLES;
+
+    imu_filter_init();
+    start = CYCLE_COUNTER();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        frame.ax = (int16_t)(i * 37);
+        frame.ay = (int16_t)(i * 91);
+        frame.az = 2048;
+        sink = imu_filter_push(&frame, &out);
+    }
+    result->sample_cycles = (CYCLE_COUNTER() - start) / BENCH_SAMPLES;
+    (void)sink;
+    imu_filter_init();
+}
+#endif /* FILTER_BENCHMARK */
@@ -0,0 +1,113 @@
+/**
+ * @file imu_ring.c
+ * @brief Ring of timestamped 6-DoF samples handed from the acquisition interrupts to the main loop in blocks.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Single producer, single consumer. The producer is the FIFO read chain in
+ * interrupt context, it fills the ring one sample at a time through imu_ring_slot()
+ * and imu_ring_commit(). The consumer is the main loop, it only ever sees whole
+ * blocks of IMU_BLOCK_LEN samples: a block is visible once the producer has moved
+ * past it, and stays the consumer's until imu_ring_release(). With two blocks this
+ * is a ping-pong buffer; more blocks absorb a main loop stalled on the SD card.
+ * The producer never writes into an unreleased block, so a block can't tear: when
+ * the ring is full new samples are counted as dropped instead. Both indices run
+ * freely and are masked on access, each one is written by one side only.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * User-defined libraries
+ */
+#include "stm32f4xx.h"
+#include "imu_ring.h"
+
+#if (IMU_RING_LEN & (IMU_RING_LEN - 1)) != 0 || (IMU_BLOCK_LEN & (IMU_BLOCK_LEN - 1)) != 0 || IMU_RING_BLOCKS < 2
+#error "IMU_RING_LEN and IMU_BLOCK_LEN must be powers of two with at least two blocks"
+#endif
+
+/**
+ * User defined variables
+ */
+static IMUFRAME imu_ring[IMU_RING_LEN];
+static volatile uint32_t ring_head = 0;   // next sample the producer writes
+static volatile uint32_t ring_tail = 0;   // first sample of the oldest unreleased block
+static IMURINGSTATS ring_stats;
+
+/**
+ * @brief Gives the producer the slot for the next sample.
+ * @note Interrupt context. The slot is not visible until imu_ring_commit().
+ * @return Slot to fill, NULL when the ring is full and the sample must be dropped.
+ */
+IMUFRAME *imu_ring_slot(void)
+{
+    if (ring_head - ring_tail >= IMU_RING_LEN)
+    {
+        ring_stats.dropped++;
+        return NULL;
+    }
+    return &imu_ring[ring_head & (IMU_RING_LEN - 1)];
+}
+
+/**
+ * @brief Publishes the sample written into the last imu_ring_slot().
+ * @note Interrupt context.
+ */
+void imu_ring_commit(void)
+{
+    uint32_t fill;
+
+    __DMB();   // the sample is in memory before the consumer can see the index move
+    ring_head++;
+    ring_stats.frames++;
+    fill = ring_head - ring_tail;
+    if (fill > ring_stats.max_fill)
+    {
+        ring_stats.max_fill = (uint16_t)fill;
+    }
+}
+
+/**
+ * @brief Returns the oldest completed block without removing it.
+ * @note Main loop. The block stays valid and unchanged until imu_ring_release().
+ * @return IMU_BLOCK_LEN samples oldest first, NULL when no block is complete.
+ */
+const IMUFRAME *imu_ring_block(void)
+{
+    uint32_t tail = ring_tail;
+
+    if (ring_head - tail < IMU_BLOCK_LEN)
+    {
+        return NULL;
+    }
+    __DMB();   // read the samples only after the index that published them
+    return &imu_ring[tail & (IMU_RING_LEN - 1)];
+}
+
+/**
+ * @brief Hands the block returned by imu_ring_block() back to the producer.
+ * @note Main loop.
+ */
+void imu_ring_release(void)
+{
+    if (ring_head - ring_tail < IMU_BLOCK_LEN)
+    {
+        return;
+    }
+    __DMB();   // finish reading the block before the producer may overwrite it
+    ring_tail += IMU_BLOCK_LEN;
+    ring_stats.blocks++;
+}
+
+/**
+ * @brief Copies the ring counters.
+ * @param stats: Destination.
+ */
+void imu_ring_stats(IMURINGSTATS *stats)
+{
+    *stats = ring_stats;
+}
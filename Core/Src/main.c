@@ -42,49 +42,62 @@
 #include "systick.h"
 #include "events.h"
 #include "fatfs_sd.h"
+#include <parse_NMEA.h>
+#include "gps_config.h"
+#include "mpu6050.h"
+#include "timestamp.h"
+#include "imu_convert.h"
+#include "sensor_registry.h"
+#include "imu_ring.h"
+#include "maneuver.h"
+#include "blackbox.h"
+#include "imu_filter.h"
+#include "attitude.h"
 
 /**
  * User defined functions
  */
-void MPU6050_Init(void);
-void MPU6050_Read_Accel(void);
+void IMU_Acquire(void);
+static int16_t sat_i16(int32_t v);
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
 static void MX_SPI2_Init(void);
 
-/**
- * User defined macros
- */
-/*Datasheet Value: 0x68*/
-#define MPU6050_ADDR 0xD0
-#define SMPLRT_DIV_REG 0x19
-#define GYRO_CONFIG_REG 0x1B
-#define ACCEL_CONFIG_REG 0x1C
-#define ACCEL_XOUT_H_REG 0x3B
-#define TEMP_OUT_H_REG 0x41
-#define GYRO_XOUT_H_REG 0x43
-#define PWR_MGMT_1_REG 0x6B
-#define WHO_AM_I_REG 0x75
-
 /**
  * User defined variables
  */
 int16_t Accel_X_RAW = 0;
 int16_t Accel_Y_RAW = 0;
 int16_t Accel_Z_RAW = 0;
-int16_t systick_count = 0;
 
 int16_t Gyro_X_RAW = 0;
 int16_t Gyro_Y_RAW = 0;
 int16_t Gyro_Z_RAW = 0;
 
-int16_t x_axis_buffer[51] = {0};
-int16_t y_axis_buffer[51] = {0};
-int16_t z_axis_buffer[51] = {0};
-uint8_t buff_incr = 0;
-float Ax, Ay, Az, Gx, Gy, Gz;
 uint8_t check;
+IMUFILTEROUT imu_streams; // filtered 100 Hz and 10 Hz acceleration
+VEHICLEMOTION vehicle;    // last sample in the vehicle frame
+VEHICLEMOTION vehicle_10hz;
+MANEUVER maneuver;
 char buffer[1024]; // to store data
+GPSCFGSTATUS gps_cfg_status;
+
+/**
+ * GPS receiver settings: 5 fixes per second at 115200 baud. VTG and GLL repeat
+ * what RMC and GGA already carry, GSV is only needed once per second.
+ */
+static const GPSCONFIG gps_settings = {
+    .baud = 115200,
+    .meas_period_ms = 200,
+    .nmea_rate = {
+        [NMEA_GGA] = 1,
+        [NMEA_RMC] = 1,
+        [NMEA_GSA] = 1,
+        [NMEA_GSV] = 5,
+        [NMEA_VTG] = 0,
+        [NMEA_GLL] = 0,
+    },
+};
 
 /**
  * SPI2 Module instance
@@ -122,78 +135,104 @@ int main(void)
   MX_GPIO_Init();
   MX_SPI2_Init();
   MX_FATFS_Init();
-  I2C_Config();
-  MPU6050_Init();
+  timestamp_init();
+  event_init();
+  maneuver_init();
+  blackbox_init();
+  imu_filter_init();
+  attitude_init();
   SysTick_Config(16000000/1000); // set tick to every 1ms
   Uart2Config();
+  // Blocks for up to a few seconds without a receiver, done before the IMU FIFO starts filling.
+  // On failure USART2 stays at the rate the receiver answered at and its NMEA output is still parsed.
+  gps_cfg_status = GPS_configure(&gps_settings);
+  I2C_Config();
+  if (MPU6050_Init())
+  {
+	  uint8_t accel_fs_sel = MPU6050_ACCEL_FS_SEL, gyro_fs_sel = MPU6050_GYRO_FS_SEL;
+
+	  // Unit conversion follows whatever range the sensor reports
+	  MPU6050_Read_Range(&accel_fs_sel, &gyro_fs_sel);
+	  imu_convert_init(accel_fs_sel, gyro_fs_sel);
+	  MPU6050_FIFO_Enable();
+	  MPU6050_DRDY_Init();
+  }
 
   while (1)
   {
-	  if(systick_count == 50)
-	  	  {
-	  		  event_analysis(x_axis_buffer, y_axis_buffer, z_axis_buffer);
-	  		  buff_incr = 0;
-	  		  USART2->CR1 |= (1<<13); //UART ENABLE
-	  		  NVIC_EnableIRQ(USART2_IRQn);
-	  	  }
-
-	  MPU6050_Read_Accel();
-	  delay_ms_systick(100);
+	  if (event_log_due())
+	  {
+		  event_log();
+	  }
+	  while (maneuver_pop(&maneuver))
+	  {
+		  event_maneuver(&maneuver);
+	  }
+	  blackbox_service();
+
+	  // Sensor timing comes from the data-ready interrupt, the loop only consumes
+	  NMEA_process();
+	  IMU_Acquire();
+	  sensor_poll();
+	  I2C_Service();
   }
 
 }
 
 /**
-  * @brief MPU6050_Init function initializes the Accelerometer module with all required configurations
-  * @param None
-  * @retval None
+  * @brief Saturates a milli-g value to the int16 range of the event window.
+  * @param 	v: Value
+  * @retval Saturated value
   */
-void MPU6050_Init(void)
+static int16_t sat_i16(int32_t v)
 {
-	uint8_t check;
-	uint8_t Data;
-	// check device ID WHO_AM_I
-	MPU_Read (MPU6050_ADDR,WHO_AM_I_REG, &check, 1);
-	if (check == 104)  // 0x68 will be returned by the sensor if everything goes well
-	{
-		// power management register 0X6B we should write all 0's to wake the sensor up
-		Data = 0;
-		MPU_Write (MPU6050_ADDR, PWR_MGMT_1_REG, Data);
-		// Set DATA RATE of 1KHz by writing SMPLRT_DIV register
-		Data = 0x07;
-		MPU_Write(MPU6050_ADDR, SMPLRT_DIV_REG, Data);
-		// Set accelerometer configuration in ACCEL_CONFIG Register
-		// XA_ST=0,YA_ST=0,ZA_ST=0, FS_SEL=0 -> ? 2g
-		Data = 0x18;
-		MPU_Write(MPU6050_ADDR, ACCEL_CONFIG_REG, Data);
-		// Set Gyroscopic configuration in GYRO_CONFIG Register
-		// XG_ST=0,YG_ST=0,ZG_ST=0, FS_SEL=0 -> ? 250 ?/s
-		Data = 0x00;
-		MPU_Write(MPU6050_ADDR, GYRO_CONFIG_REG, Data);
-	}
+	return (v > INT16_MAX) ? INT16_MAX : (v < INT16_MIN) ? INT16_MIN : (int16_t)v;
 }
 
 /**
-  * @brief MPU6050_ReAD_Accel uses MPU_Read to read data from the slave and store it in three different buffers.
+  * @brief IMU_Acquire takes every completed block of the imu_ring, rotates every sample into the
+  * 	   vehicle frame for the maneuver detector, records it in the crash black box and feeds
+  * 	   the sliding event window. Window entries come from the 10 Hz stream of the filter
+  * 	   pipeline, so vibration above the 3 Hz anti-alias corner no longer reaches the thresholds.
+  * 	   50 entries span 5 seconds of samples however long the loop took.
   * @param 	None
   * @retval None
   */
-void MPU6050_Read_Accel(void)
+void IMU_Acquire(void)
 {
-	uint8_t Rx_data[6];
-	// Read 6 BYTES of data starting from ACCEL_XOUT_H register
-	MPU_Read (MPU6050_ADDR, ACCEL_XOUT_H_REG, Rx_data, 6);
-	Accel_X_RAW = (int16_t)(Rx_data[0] << 8 | Rx_data [1]);
-	Accel_Y_RAW = (int16_t)(Rx_data[2] << 8 | Rx_data [3]);
-	Accel_Z_RAW = (int16_t)(Rx_data[4] << 8 | Rx_data [5]);
-	systick_count++;
-	Ax = Accel_X_RAW/2048.0;
-	Ay = Accel_Y_RAW/2048.0;
-	Az = Accel_Z_RAW/2048.0;
-	x_axis_buffer[buff_incr] = Accel_X_RAW;
-	y_axis_buffer[buff_incr] = Accel_Y_RAW;
-	z_axis_buffer[buff_incr] = Accel_Z_RAW;
-	buff_incr++;
+	const IMUFRAME *block;
+	uint8_t streams;
+
+	// Each block stays untouched by the acquisition until it is released
+	while ((block = imu_ring_block()) != NULL)
+	{
+		for (uint16_t i = 0; i < IMU_BLOCK_LEN; i++)
+		{
+			attitude_update(&block[i], &vehicle);
+			maneuver_update(block[i].t_us, &vehicle);
+
+			streams = imu_filter_push(&block[i], &imu_streams);
+			if (streams & IMU_STREAM_100HZ)
+			{
+				attitude_calibrate(&imu_streams);
+			}
+			// Every 10 Hz output slides the event window on by one, no entry is dropped while logging
+			if (streams & IMU_STREAM_10HZ)
+			{
+				Accel_X_RAW = imu_streams.lp10[0];
+				Accel_Y_RAW = imu_streams.lp10[1];
+				Accel_Z_RAW = imu_streams.lp10[2];
+				attitude_to_vehicle(imu_streams.lp10, &vehicle_10hz);
+				event_update(sat_i16(vehicle_10hz.lat_mg), sat_i16(vehicle_10hz.lon_mg), sat_i16(vehicle_10hz.vert_mg));
+			}
+		}
+
+		Gyro_X_RAW = block[IMU_BLOCK_LEN - 1].gx;
+		Gyro_Y_RAW = block[IMU_BLOCK_LEN - 1].gy;
+		Gyro_Z_RAW = block[IMU_BLOCK_LEN - 1].gz;
+		blackbox_block(block);
+		imu_ring_release();
+	}
 }
 
 /**
@@ -0,0 +1,268 @@
+/**
+ * @file maneuver.c
+ * @brief Streaming harsh braking, acceleration and cornering detector run on every IMU sample.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Each sample costs the same: a 16 ms exponential smoothing of the horizontal
+ * axes, a jerk from a fixed delay line and one step of a state machine, with no loops
+ * and no division; the peaks are rounded once per event. The horizontal acceleration
+ * magnitude is compared squared against squared thresholds. An event enters at its
+ * enter threshold, or already at its exit threshold when the jerk shows a sharp
+ * onset, and leaves below its exit threshold, so a signal hovering around one limit
+ * does not chatter. Events shorter than their minimum duration are counted and
+ * dropped. Input comes in the vehicle frame from the attitude filter, so the
+ * thresholds hold however the unit is mounted.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "maneuver.h"
+#include "mpu6050.h"
+
+/**
+ * User defined Macros
+ */
+#define SMOOTH_SHIFT	(4)		// exponential smoothing over 2^4 samples, 16 ms at 1 kHz
+#define JERK_SHIFT		(4)
+#define JERK_LAG		(1 << JERK_SHIFT)	// samples between the two ends of the jerk difference
+
+/**
+ * @brief Thresholds of one maneuver kind.
+ */
+typedef struct {
+    int32_t enter_mg;      /**< Horizontal magnitude that starts the event. */
+    int32_t exit_mg;       /**< Horizontal magnitude below which the event ends. */
+    int32_t jerk_mgps;     /**< Jerk that starts the event from exit_mg already. */
+    int32_t yaw_mdps;      /**< Yaw rate the event needs to start, 0 for none. */
+    uint32_t min_us;       /**< Shorter events are rejected. */
+} MANEUVERCFG;
+
+/**
+ * User defined variables
+ */
+static const MANEUVERCFG maneuver_cfg[MANEUVER_KINDS] = {
+    [MANEUVER_BRAKE]  = { 350, 200, 1500, 0,     150000 },
+    [MANEUVER_ACCEL]  = { 300, 150, 1500, 0,     150000 },
+    [MANEUVER_CORNER] = { 350, 200, 1500, 10000, 300000 },
+};
+
+static int32_t smooth_q[2];              // long, lat in mg << SMOOTH_SHIFT
+static int16_t lag_mg[2][JERK_LAG];      // smoothed long, lat JERK_LAG samples ago
+static uint32_t lag_pos = 0;
+static uint32_t primed = 0;              // samples seen, up to JERK_LAG
+static int8_t active = -1;               // MANEUVERKIND in progress, -1 for none
+static MANEUVER current;
+static uint32_t peak_sq;
+static int32_t peak_yaw;
+
+static MANEUVER queue[MANEUVER_QUEUE_LEN];
+static uint32_t queue_head = 0;
+static uint32_t queue_tail = 0;
+static MANEUVERSTATS maneuver_counters;
+
+#if (MANEUVER_QUEUE_LEN & (MANEUVER_QUEUE_LEN - 1)) != 0
+#error "MANEUVER_QUEUE_LEN must be a power of two"
+#endif
+
+/**
+ * @brief Integer square root.
+ * @param x: Value.
+ * @return floor(sqrt(x)).
+ */
+static uint32_t isqrt(uint32_t x)
+{
+    uint32_t r = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > x)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (x >= r + bit)
+        {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+        {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+/**
+ * @brief Saturates to 16 bits unsigned.
+ */
+static uint16_t sat_u16(int32_t v)
+{
+    return (v < 0) ? 0 : (v > 0xFFFF) ? 0xFFFF : (uint16_t)v;
+}
+
+/**
+ * @brief Closes the event in progress and queues it when it lasted long enough.
+ * @param t_us: Timestamp of the sample that ended it.
+ */
+static void maneuver_finish(uint32_t t_us)
+{
+    uint32_t duration = t_us - current.start_us;
+
+    if (duration < maneuver_cfg[active].min_us)
+    {
+        maneuver_counters.rejected++;
+    }
+    else if (queue_head - queue_tail >= MANEUVER_QUEUE_LEN)
+    {
+        maneuver_counters.queue_full++;
+    }
+    else
+    {
+        current.end_us = t_us;
+        current.duration_ms = sat_u16((int32_t)(duration / 1000));
+        current.peak_mg = sat_u16((int32_t)isqrt(peak_sq));   // once per event, not per sample
+        current.peak_yaw_dps = (peak_yaw >= 255000) ? 255 : (uint8_t)(peak_yaw / 1000);
+        queue[queue_head & (MANEUVER_QUEUE_LEN - 1)] = current;
+        queue_head++;
+        maneuver_counters.events[active]++;
+    }
+    active = -1;
+}
+
+/**
+ * @brief Clears the detector state and the event queue.
+ */
+void maneuver_init(void)
+{
+    smooth_q[0] = smooth_q[1] = 0;
+    lag_pos = 0;
+    primed = 0;
+    active = -1;
+    queue_head = queue_tail = 0;
+}
+
+/**
+ * @brief Runs the detector on one sample.
+ * @note Main loop, call for every sample in order.
+ * @param t_us: Timestamp of the sample.
+ * @param m: Its motion in the vehicle frame.
+ */
+void maneuver_update(uint32_t t_us, const VEHICLEMOTION *m)
+{
+    int32_t lon, lat, yaw, jerk_lon, jerk_lat, jerk, v;
+    uint32_t mag_sq;
+    const MANEUVERCFG *cfg;
+    int8_t kind;
+
+    // Smoothed horizontal acceleration in mg, primed with the first sample
+    lon = m->lon_mg;
+    lat = m->lat_mg;
+    yaw = m->yaw_mdps;
+    if (primed == 0)
+    {
+        smooth_q[0] = lon << SMOOTH_SHIFT;
+        smooth_q[1] = lat << SMOOTH_SHIFT;
+    }
+    smooth_q[0] += lon - (smooth_q[0] >> SMOOTH_SHIFT);
+    smooth_q[1] += lat - (smooth_q[1] >> SMOOTH_SHIFT);
+    lon = smooth_q[0] >> SMOOTH_SHIFT;
+    lat = smooth_q[1] >> SMOOTH_SHIFT;
+    yaw = (yaw < 0) ? -yaw : yaw;
+
+    // Jerk over the delay line, the oldest entry is replaced by the newest
+    jerk_lon = ((lon - lag_mg[0][lag_pos]) * MPU6050_SAMPLE_RATE_HZ) >> JERK_SHIFT;
+    jerk_lat = ((lat - lag_mg[1][lag_pos]) * MPU6050_SAMPLE_RATE_HZ) >> JERK_SHIFT;
+    lag_mg[0][lag_pos] = (int16_t)lon;
+    lag_mg[1][lag_pos] = (int16_t)lat;
+    lag_pos = (lag_pos + 1) & (JERK_LAG - 1);
+    if (primed < JERK_LAG)
+    {
+        primed++;
+        return;
+    }
+
+    // The dominant horizontal axis and its sign decide the kind
+    mag_sq = (uint32_t)(lon * lon + lat * lat);
+    if (((lon < 0) ? -lon : lon) >= ((lat < 0) ? -lat : lat))
+    {
+        kind = (lon < 0) ? MANEUVER_BRAKE : MANEUVER_ACCEL;
+        jerk = (lon < 0) ? -jerk_lon : jerk_lon;
+    }
+    else
+    {
+        kind = MANEUVER_CORNER;
+        jerk = (lat < 0) ? -jerk_lat : jerk_lat;
+    }
+
+    if (active < 0)
+    {
+        cfg = &maneuver_cfg[kind];
+        v = (jerk >= cfg->jerk_mgps) ? cfg->exit_mg : cfg->enter_mg;
+        if (mag_sq >= (uint32_t)(v * v) && yaw >= cfg->yaw_mdps)
+        {
+            active = kind;
+            current.start_us = t_us;
+            current.kind = (uint8_t)kind;
+            current.peak_jerk = 0;
+            peak_sq = 0;
+            peak_yaw = 0;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    // Track the peaks while the magnitude stays above the exit threshold of the kind that started
+    cfg = &maneuver_cfg[active];
+    if (mag_sq < (uint32_t)(cfg->exit_mg * cfg->exit_mg))
+    {
+        maneuver_finish(t_us);
+        return;
+    }
+    if (mag_sq > peak_sq)
+    {
+        peak_sq = mag_sq;
+    }
+    if (kind == active && jerk > current.peak_jerk)
+    {
+        current.peak_jerk = sat_u16(jerk);
+    }
+    if (yaw > peak_yaw)
+    {
+        peak_yaw = yaw;
+    }
+}
+
+/**
+ * @brief Takes the oldest finished event.
+ * @param m: Destination.
+ * @return 1 when an event was copied, 0 when none is waiting.
+ */
+uint8_t maneuver_pop(MANEUVER *m)
+{
+    if (queue_head == queue_tail)
+    {
+        return 0;
+    }
+    *m = queue[queue_tail & (MANEUVER_QUEUE_LEN - 1)];
+    queue_tail++;
+    return 1;
+}
+
+/**
+ * @brief Copies the detector counters.
+ * @param stats: Destination.
+ */
+void maneuver_stats(MANEUVERSTATS *stats)
+{
+    *stats = maneuver_counters;
+}
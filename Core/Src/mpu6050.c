@@ -0,0 +1,307 @@
+/**
+ * @file mpu6050.c
+ * @brief MPU6050 accelerometer/gyroscope driver, hardware FIFO acquisition.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note In FIFO mode the sensor queues accel, temperature and gyro frames at
+ * MPU6050_SAMPLE_RATE_HZ and the host collects everything that accumulated with one
+ * status read, one count read and one burst read of FIFO_R_W. The three reads are chained from I2C completion
+ * callbacks, started from the data-ready interrupt every MPU6050_BATCH_FRAMES samples,
+ * and the last callback unpacks the burst straight into the imu_ring, so the burst
+ * buffer is free again before the next data-ready interrupt. The data-ready interrupt also
+ * stamps each sample with TIM2, FIFO frames are matched to stamps by sequence number
+ * since both advance once per sample. Each frame is the 14-byte block from
+ * ACCEL_XOUT_H to GYRO_ZOUT_L in register order, the six axes and the temperature of
+ * one sample. 1 kHz of them is 14 KB/s, about a third of what the 400 kHz bus carries,
+ * and the 1024-byte FIFO holds 73 ms.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * User-defined libraries
+ */
+#include "main.h"
+#include "i2c.h"
+#include "timestamp.h"
+#include "sensor_registry.h"
+#include "imu_ring.h"
+#include "mpu6050.h"
+
+/**
+ * User defined variables
+ */
+static uint8_t fifo_raw[MPU6050_FIFO_MAX_FRAMES * MPU6050_FRAME_BYTES];
+static uint8_t fifo_status;
+static uint8_t fifo_count_raw[2];
+static uint16_t fifo_pending_frames;            // frames requested by the burst on the bus
+static volatile uint8_t fifo_busy = 0;          // a read chain owns fifo_raw
+static MPUFIFOSTATS fifo_stats;
+static int8_t mpu6050_handle = -1;
+static volatile int16_t mpu6050_temp = 0;
+
+/**
+ * Data-ready timestamps indexed by sample sequence number. drdy_seq counts
+ * interrupts, fifo_next_seq is the sequence number of the oldest frame still in
+ * the sensor FIFO and fifo_first_seq the one of fifo_raw[0].
+ */
+static volatile uint32_t drdy_stamp[MPU6050_STAMP_RING];
+static volatile uint32_t drdy_seq = 0;
+static uint32_t drdy_kick_seq = 0;
+static uint32_t fifo_next_seq = 0;
+static uint32_t fifo_first_seq = 0;
+static uint8_t fifo_resync = 1;                  // FIFO restarted, realign sequence numbers
+
+#if (MPU6050_STAMP_RING & (MPU6050_STAMP_RING - 1)) != 0
+#error "MPU6050_STAMP_RING must be a power of two"
+#endif
+
+/**
+ * Start-up configuration, applied in order after WHO_AM_I matched
+ */
+static const SENSORREG mpu6050_init_seq[] = {
+    { PWR_MGMT_1_REG, 0x00 },     // wake up, internal oscillator
+    { CONFIG_REG, 0x03 },         // DLPF_CFG=3: 44 Hz accel / 42 Hz gyro bandwidth, 1 kHz internal rate
+    { SMPLRT_DIV_REG, 0x00 },     // sample rate 1 kHz / (1 + 0) = 1 kHz
+    { ACCEL_CONFIG_REG, MPU6050_ACCEL_FS_SEL << MPU6050_FS_SEL_SHIFT },   // AFS_SEL=3 -> +-16 g, 2048 LSB/g
+    { GYRO_CONFIG_REG, MPU6050_GYRO_FS_SEL << MPU6050_FS_SEL_SHIFT },     // FS_SEL=0 -> +-250 deg/s
+};
+
+/**
+ * Motion data and temperature come through the FIFO path, the registry only configures the sensor
+ */
+static const SENSORDRIVER mpu6050_driver = {
+    .name = "MPU6050",
+    .address = MPU6050_ADDR,
+    .id_reg = WHO_AM_I_REG,
+    .id_value = MPU6050_WHO_AM_I,
+    .init = mpu6050_init_seq,
+    .init_len = sizeof(mpu6050_init_seq) / sizeof(mpu6050_init_seq[0]),
+    .period_ms = 0,
+};
+
+/**
+ * @brief Initializes the MPU6050 with all required configurations.
+ * @return 1 if the sensor answered WHO_AM_I and took its configuration, 0 otherwise.
+ */
+uint8_t MPU6050_Init(void)
+{
+    mpu6050_handle = sensor_register(&mpu6050_driver);
+    return sensor_init(mpu6050_handle);
+}
+
+/**
+ * @brief Die temperature of the last FIFO burst.
+ * @return Raw TEMP_OUT, deg C = temp / 340 + 36.53.
+ */
+int16_t MPU6050_Temperature(void)
+{
+    return mpu6050_temp;
+}
+
+/**
+ * @brief Decodes one big-endian ACCEL_XOUT_H..GYRO_ZOUT_L block.
+ * @param block: MPU6050_FRAME_BYTES bytes, accel X/Y/Z, temperature, gyro X/Y/Z.
+ * @param frame: Destination, the timestamp is left untouched.
+ * @return Raw TEMP_OUT.
+ */
+static int16_t mpu6050_unpack(const uint8_t *block, IMUFRAME *frame)
+{
+    frame->ax = (int16_t)(block[0] << 8 | block[1]);
+    frame->ay = (int16_t)(block[2] << 8 | block[3]);
+    frame->az = (int16_t)(block[4] << 8 | block[5]);
+    frame->gx = (int16_t)(block[8] << 8 | block[9]);
+    frame->gy = (int16_t)(block[10] << 8 | block[11]);
+    frame->gz = (int16_t)(block[12] << 8 | block[13]);
+    return (int16_t)(block[6] << 8 | block[7]);
+}
+
+/**
+ * @brief Reads back the full-scale selections the sensor is running with.
+ * @note Waits for the I2C queue to drain, for start-up.
+ * @param accel_fs_sel: AFS_SEL of ACCEL_CONFIG.
+ * @param gyro_fs_sel: FS_SEL of GYRO_CONFIG.
+ * @return 1 on success, 0 on an I2C error.
+ */
+uint8_t MPU6050_Read_Range(uint8_t *accel_fs_sel, uint8_t *gyro_fs_sel)
+{
+    uint8_t config[2] = {0};   // GYRO_CONFIG, ACCEL_CONFIG
+
+    MPU_Read(MPU6050_ADDR, GYRO_CONFIG_REG, config, 2, NULL, NULL);
+    if (I2C_Wait() != I2C_OK)
+    {
+        return 0;
+    }
+    *gyro_fs_sel = (config[0] >> MPU6050_FS_SEL_SHIFT) & 3;
+    *accel_fs_sel = (config[1] >> MPU6050_FS_SEL_SHIFT) & 3;
+    return 1;
+}
+
+/**
+ * @brief Empties the FIFO and restarts writing accel and gyro frames into it.
+ * @note Only queues the register writes. Also used from the read chain to
+ *       resynchronise after an overflow, when frame boundaries are lost.
+ */
+void MPU6050_FIFO_Enable(void)
+{
+    MPU_Write(MPU6050_ADDR, USER_CTRL_REG, 0x00);
+    MPU_Write(MPU6050_ADDR, FIFO_EN_REG, 0x00);
+    MPU_Write(MPU6050_ADDR, USER_CTRL_REG, USER_CTRL_FIFO_RESET);
+    MPU_Read(MPU6050_ADDR, INT_STATUS_REG, &fifo_status, 1, NULL, NULL);   // clear a stale overflow flag
+    MPU_Write(MPU6050_ADDR, INT_ENABLE_REG, INT_FIFO_OFLOW | INT_DATA_RDY);
+    fifo_resync = 1;
+    MPU_Write(MPU6050_ADDR, FIFO_EN_REG, FIFO_EN_MOTION);
+    MPU_Write(MPU6050_ADDR, USER_CTRL_REG, USER_CTRL_FIFO_EN);
+}
+
+/**
+ * @brief Read chain step 3, the burst of frames arrived, unpacks and stamps it into the imu_ring.
+ * @note Frames the ring has no room for are counted there as dropped. The temperature of
+ *       the last stored frame becomes MPU6050_Temperature().
+ * @param status: I2C outcome.
+ * @param ctx: Unused.
+ */
+static void fifo_data_done(I2CSTATUS status, void *ctx)
+{
+    const uint8_t *p = fifo_raw;
+    IMUFRAME *f;
+
+    if (status == I2C_OK)
+    {
+        for (uint16_t i = 0; i < fifo_pending_frames; i++, p += MPU6050_FRAME_BYTES)
+        {
+            f = imu_ring_slot();
+            if (f == NULL)
+            {
+                continue;
+            }
+            f->t_us = drdy_stamp[(fifo_first_seq + i) & (MPU6050_STAMP_RING - 1)];
+            mpu6050_temp = mpu6050_unpack(p, f);
+            imu_ring_commit();
+        }
+        fifo_stats.bursts++;
+        fifo_stats.frames += fifo_pending_frames;
+    }
+    fifo_busy = 0;
+}
+
+/**
+ * @brief Read chain step 2, INT_STATUS and FIFO_COUNT arrived, reads the whole frames.
+ * @note On overflow the FIFO holds a partial frame at its head, so the content is
+ *       dropped and the FIFO restarted, and the gap shows up in the overflow count.
+ * @param status: I2C outcome.
+ * @param ctx: Unused.
+ */
+static void fifo_count_done(I2CSTATUS status, void *ctx)
+{
+    uint16_t count = (uint16_t)(fifo_count_raw[0] << 8 | fifo_count_raw[1]);
+    uint16_t frames = count / MPU6050_FRAME_BYTES;
+
+    if (status != I2C_OK)
+    {
+        fifo_busy = 0;
+        return;
+    }
+    if ((fifo_status & INT_FIFO_OFLOW) || count >= MPU6050_FIFO_SIZE)
+    {
+        fifo_stats.overflows++;
+        MPU6050_FIFO_Enable();
+        fifo_busy = 0;
+        return;
+    }
+    if (fifo_resync)
+    {
+        // Newest frame in the FIFO belongs to the latest data-ready interrupt
+        fifo_next_seq = drdy_seq - count / MPU6050_FRAME_BYTES;
+        fifo_resync = 0;
+    }
+    if (frames > MPU6050_FIFO_MAX_FRAMES)
+    {
+        frames = MPU6050_FIFO_MAX_FRAMES;
+    }
+    fifo_first_seq = fifo_next_seq;
+    fifo_next_seq += frames;
+    fifo_pending_frames = frames;
+    if (frames == 0 || !MPU_Read(MPU6050_ADDR, FIFO_R_W_REG, fifo_raw, frames * MPU6050_FRAME_BYTES, fifo_data_done, NULL))
+    {
+        fifo_busy = 0;
+    }
+}
+
+/**
+ * @brief Read chain step 1, queues the INT_STATUS and FIFO_COUNT reads.
+ */
+static void fifo_poll_start(void)
+{
+    fifo_busy = 1;
+    if (!MPU_Read(MPU6050_ADDR, INT_STATUS_REG, &fifo_status, 1, NULL, NULL) ||
+        !MPU_Read(MPU6050_ADDR, FIFO_COUNTH_REG, fifo_count_raw, 2, fifo_count_done, NULL))
+    {
+        fifo_busy = 0;
+    }
+}
+
+/**
+ * @brief Routes the sensor INT pin to an EXTI rising edge interrupt.
+ * @note The data-ready source itself is enabled by MPU6050_FIFO_Enable().
+ */
+void MPU6050_DRDY_Init(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
+    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+
+    // Input, pull-down so a floating pin does not fire
+    MPU6050_INT_PORT->MODER &= ~(3U << (MPU6050_INT_PIN * 2));
+    MPU6050_INT_PORT->PUPDR = (MPU6050_INT_PORT->PUPDR & ~(3U << (MPU6050_INT_PIN * 2))) | (2U << (MPU6050_INT_PIN * 2));
+
+    SYSCFG->EXTICR[MPU6050_INT_PIN / 4] = (SYSCFG->EXTICR[MPU6050_INT_PIN / 4] & ~(0xFU << ((MPU6050_INT_PIN % 4) * 4)))
+                                        | MPU6050_INT_EXTICR;
+    EXTI->RTSR |= (1U << MPU6050_INT_PIN);
+    EXTI->FTSR &= ~(1U << MPU6050_INT_PIN);
+    EXTI->PR = (1U << MPU6050_INT_PIN);
+    EXTI->IMR |= (1U << MPU6050_INT_PIN);
+
+    // Same priority as I2C3 so the read chain state is never preempted
+    NVIC_SetPriority(MPU6050_INT_IRQn, I2C3_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(MPU6050_INT_IRQn);
+    NVIC_EnableIRQ(MPU6050_INT_IRQn);
+}
+
+/**
+ * @brief Handles the sensor data-ready interrupt, stamps the sample and starts a
+ *        FIFO burst once MPU6050_BATCH_FRAMES samples are waiting.
+ * @note This function is invoked by the EXTI interrupt of the INT pin.
+ */
+void mpu6050_drdy_call(void)
+{
+    uint32_t now = TIMESTAMP_US();
+
+    if (!(EXTI->PR & (1U << MPU6050_INT_PIN)))
+    {
+        return;
+    }
+    EXTI->PR = (1U << MPU6050_INT_PIN);
+
+    drdy_stamp[drdy_seq & (MPU6050_STAMP_RING - 1)] = now;
+    drdy_seq++;
+    fifo_stats.data_ready++;
+
+    if (!fifo_busy && drdy_seq - drdy_kick_seq >= MPU6050_BATCH_FRAMES)
+    {
+        drdy_kick_seq = drdy_seq;
+        fifo_poll_start();
+    }
+}
+
+/**
+ * @brief Copies the FIFO acquisition counters.
+ * @param stats: Destination.
+ */
+void MPU6050_FIFO_Stats(MPUFIFOSTATS *stats)
+{
+    *stats = fifo_stats;
+}
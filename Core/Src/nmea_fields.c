@@ -0,0 +1,197 @@
+/**
+ * @file nmea_fields.c
+ * @brief Typed accessors for the fields of a tokenized NMEA sentence.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note The tokenizer records where every field starts while the sentence is
+ * received, so finding field n is a table lookup. The accessors decode straight
+ * from the sentence text, nothing is copied into intermediate buffers.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "nmea_fields.h"
+
+/**
+ * User defined Macros
+ */
+#define NMEA_COORD_MIN_DIGITS	(5)			// minutes fraction kept by nmea_field_coord(), 1e-5 min ~ 2 cm
+
+/**
+ * User defined variables
+ */
+static const int32_t nmea_pow10[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/**
+ * @brief Length of a field.
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index, 0 is the address field ("GPGGA").
+ * @return Number of characters, 0 for an empty or missing field.
+ */
+uint8_t nmea_field_len(const NMEASLOT *slot, uint8_t idx)
+{
+    if (idx >= slot->fields)
+    {
+        return 0;
+    }
+    return slot->field_start[idx + 1] - slot->field_start[idx] - 1;
+}
+
+/**
+ * @brief Start of a field inside the sentence text.
+ * @note The field is terminated by ',' or '*', not by '\0'. Use nmea_field_len().
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index.
+ * @return Pointer to the first character, or to an empty string for a missing field.
+ */
+const char *nmea_field(const NMEASLOT *slot, uint8_t idx)
+{
+    if (idx >= slot->fields)
+    {
+        return &slot->text[slot->len];
+    }
+    return &slot->text[slot->field_start[idx]];
+}
+
+/**
+ * @brief First character of a single character field such as N/S or A/V.
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index.
+ * @return The character, or '\0' if the field is empty.
+ */
+char nmea_field_char(const NMEASLOT *slot, uint8_t idx)
+{
+    if (nmea_field_len(slot, idx) == 0)
+    {
+        return '\0';
+    }
+    return *nmea_field(slot, idx);
+}
+
+/**
+ * @brief Decodes the integer part of a numeric field.
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index.
+ * @return Value, 0 if the field is empty.
+ */
+int32_t nmea_field_int(const NMEASLOT *slot, uint8_t idx)
+{
+    const char *p = nmea_field(slot, idx);
+    uint8_t len = nmea_field_len(slot, idx);
+    uint8_t i = 0;
+    int32_t value = 0;
+    int negative = 0;
+
+    if (len > 0 && p[0] == '-')
+    {
+        negative = 1;
+        i++;
+    }
+    for (; i < len && p[i] >= '0' && p[i] <= '9'; i++)
+    {
+        value = value * 10 + (p[i] - '0');
+    }
+    return negative ? -value : value;
+}
+
+/**
+ * @brief Decodes two digits at a fixed position, as used by hhmmss and ddmmyy fields.
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index.
+ * @param pos: Position of the first digit inside the field.
+ * @return Value 0..99, or -1 if the field is too short or not numeric there.
+ */
+int nmea_field_2digits(const NMEASLOT *slot, uint8_t idx, uint8_t pos)
+{
+    const char *p = nmea_field(slot, idx);
+
+    if (nmea_field_len(slot, idx) < pos + 2)
+    {
+        return -1;
+    }
+    if (p[pos] < '0' || p[pos] > '9' || p[pos + 1] < '0' || p[pos + 1] > '9')
+    {
+        return -1;
+    }
+    return (p[pos] - '0') * 10 + (p[pos + 1] - '0');
+}
+
+/**
+ * @brief Decodes a decimal field such as "499.6" or "0.004" into a scaled integer.
+ * @note Digits beyond frac_digits are truncated, missing ones count as 0, so
+ *       nmea_field_fixed("499.6", 2) is 49960 (centimetres for an altitude in metres).
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index.
+ * @param frac_digits: Number of fraction digits kept, 0..9.
+ * @return Value multiplied by 10^frac_digits, 0 if the field is empty.
+ */
+int32_t nmea_field_fixed(const NMEASLOT *slot, uint8_t idx, uint8_t frac_digits)
+{
+    const char *p = nmea_field(slot, idx);
+    uint8_t len = nmea_field_len(slot, idx);
+    uint8_t i = 0;
+    uint8_t kept = 0;
+    int32_t value = 0;
+    int negative = 0;
+    int fraction = 0;
+
+    if (len > 0 && p[0] == '-')
+    {
+        negative = 1;
+        i++;
+    }
+    for (; i < len; i++)
+    {
+        if (p[i] == '.')
+        {
+            fraction = 1;
+        }
+        else if (p[i] >= '0' && p[i] <= '9')
+        {
+            if (fraction)
+            {
+                if (kept == frac_digits)
+                {
+                    break;
+                }
+                kept++;
+            }
+            value = value * 10 + (p[i] - '0');
+        }
+        else
+        {
+            break;
+        }
+    }
+    value *= nmea_pow10[frac_digits - kept];
+    return negative ? -value : value;
+}
+
+/**
+ * @brief Decodes a ddmm.mmmmm / dddmm.mmmmm position field into degrees.
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index of the coordinate, the hemisphere is the next field.
+ * @return Signed degrees * 1e7 (south and west negative), 0 if the field is empty.
+ */
+int32_t nmea_field_coord(const NMEASLOT *slot, uint8_t idx)
+{
+    int32_t minutes_e5 = nmea_field_fixed(slot, idx, NMEA_COORD_MIN_DIGITS);
+    int32_t degrees = minutes_e5 / (100 * 100000);
+    int32_t coord;
+    char hemisphere = nmea_field_char(slot, idx + 1);
+
+    minutes_e5 -= degrees * (100 * 100000);
+
+    // 1e7 / (60 * 1e5) = 5/3, rounded to the nearest 1e-7 degree
+    coord = degrees * 10000000 + (minutes_e5 * 5 + 1) / 3;
+
+    return (hemisphere == 'S' || hemisphere == 'W') ? -coord : coord;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file nmea_queue.c
+ * @brief Lock-free single-producer/single-consumer queue of received NMEA sentences.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note The USART2 receive path is the only producer and the main loop the only
+ * consumer. head is written by the producer only and tail by the consumer only,
+ * so neither side has to mask interrupts.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stddef.h>
+#include "stm32f4xx.h"
+
+/**
+ * User-defined libraries
+ */
+#include "nmea_queue.h"
+
+/**
+ * User defined Macros
+ */
+#define NMEA_QUEUE_MASK		(NMEA_QUEUE_SLOTS - 1)
+
+#if (NMEA_QUEUE_SLOTS & NMEA_QUEUE_MASK) != 0
+#error "NMEA_QUEUE_SLOTS must be a power of two"
+#endif
+
+/**
+ * User defined variables
+ */
+static NMEASLOT nmea_slots[NMEA_QUEUE_SLOTS];
+static volatile uint32_t nmea_head = 0;    // next slot the producer fills
+static volatile uint32_t nmea_tail = 0;    // next slot the consumer reads
+static volatile uint32_t nmea_published = 0;
+static volatile uint32_t nmea_overflows = 0;
+static volatile uint32_t nmea_max_depth = 0;
+
+/**
+ * @brief Returns the slot the producer may fill with the next sentence.
+ * @note Producer side. The same slot is returned until nmea_queue_publish() is called.
+ * @return Pointer to a free slot, or NULL (counted as an overflow) if the consumer is behind.
+ */
+NMEASLOT *nmea_queue_claim(void)
+{
+    if ((nmea_head - nmea_tail) >= NMEA_QUEUE_SLOTS)
+    {
+        nmea_overflows++;
+        return NULL;
+    }
+    return &nmea_slots[nmea_head & NMEA_QUEUE_MASK];
+}
+
+/**
+ * @brief Hands the claimed slot over to the consumer.
+ * @note Producer side. Must only follow a successful nmea_queue_claim().
+ */
+void nmea_queue_publish(void)
+{
+    uint32_t depth;
+
+    __DMB();   // slot contents must be visible before the new head
+    nmea_head++;
+    nmea_published++;
+
+    depth = nmea_head - nmea_tail;
+    if (depth > nmea_max_depth)
+    {
+        nmea_max_depth = depth;
+    }
+}
+
+/**
+ * @brief Returns the oldest published sentence without removing it.
+ * @note Consumer side.
+ * @return Pointer to the slot, or NULL if the queue is empty.
+ */
+NMEASLOT *nmea_queue_peek(void)
+{
+    if (nmea_tail == nmea_head)
+    {
+        return NULL;
+    }
+    __DMB();   // read head before the slot contents
+    return &nmea_slots[nmea_tail & NMEA_QUEUE_MASK];
+}
+
+/**
+ * @brief Returns the slot obtained by nmea_queue_peek() to the producer.
+ * @note Consumer side.
+ */
+void nmea_queue_release(void)
+{
+    __DMB();   // finish reading the slot before the producer may reuse it
+    nmea_tail++;
+}
+
+/**
+ * @brief Number of sentences waiting for the consumer.
+ * @return Queue depth.
+ */
+uint32_t nmea_queue_depth(void)
+{
+    return nmea_head - nmea_tail;
+}
+
+/**
+ * @brief Copies the queue health counters.
+ * @param stats: Destination for the counters.
+ */
+void nmea_queue_stats(NMEAQUEUESTATS *stats)
+{
+    stats->published = nmea_published;
+    stats->overflows = nmea_overflows;
+    stats->max_depth = nmea_max_depth;
+}
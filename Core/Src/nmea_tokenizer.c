@@ -0,0 +1,303 @@
+/**
+ * @file nmea_tokenizer.c
+ * @brief Byte-at-a-time NMEA 0183 tokenizer feeding the sentence queue.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Runs in the USART2 receive interrupt. Each byte is looked at once and
+ * copied once, from the DMA buffer into the queue slot, so the cost per byte is
+ * constant and does not depend on where the receiver puts a sentence in its burst.
+ * The XOR checksum is accumulated on the way, so a corrupted sentence is dropped
+ * here and never reaches the parsers or the SD card. Field boundaries are recorded
+ * in the slot in the same pass, see nmea_fields.c.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * User-defined libraries
+ */
+#include "systick.h"
+#include "nmea_queue.h"
+#include "nmea_tokenizer.h"
+
+/**
+ * User defined Macros
+ */
+#define NMEA_TALKER_LEN		(2)
+#define NMEA_TYPE_LEN		(3)
+#define NMEA_ID(a, b, c)	(((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(c))
+
+/**
+ * @brief Tokenizer states, one sentence is "$" talker type { "," field } [ "*" hh ] CR LF.
+ */
+typedef enum {
+    TOK_HUNT = 0,      /**< Waiting for '$'. */
+    TOK_TALKER,        /**< Two talker characters. */
+    TOK_TYPE,          /**< Three sentence type characters. */
+    TOK_FIELDS,        /**< Comma separated fields. */
+    TOK_CHECKSUM       /**< Two hex digits after '*'. */
+} TOKSTATE;
+
+/**
+ * User defined variables
+ */
+static TOKSTATE tok_state = TOK_HUNT;
+static NMEASLOT *tok_slot = NULL;   // queue slot the current sentence is written into
+static uint8_t tok_len = 0;         // characters written into the slot
+static uint8_t tok_count = 0;       // characters seen in the current talker/type/checksum token
+static uint8_t tok_fields = 0;      // fields started so far, including the address field
+static uint32_t tok_id = 0;         // sentence type characters packed by NMEA_ID()
+static NMEATYPE tok_type = NMEA_UNKNOWN;
+static uint8_t tok_sum = 0;         // XOR of every character between '$' and '*'
+static uint8_t tok_rx_sum = 0;      // checksum transmitted after '*'
+static volatile NMEALINKSTATS tok_stats[NMEA_TYPE_COUNT];
+
+/**
+ * @brief Maps the packed three letter sentence ID to its type.
+ * @param id: Packed sentence ID.
+ * @return Sentence type, NMEA_UNKNOWN for sentences without a parser.
+ */
+static NMEATYPE nmea_type_lookup(uint32_t id)
+{
+    switch (id)
+    {
+        case NMEA_ID('G', 'G', 'A'): return NMEA_GGA;
+        case NMEA_ID('R', 'M', 'C'): return NMEA_RMC;
+        case NMEA_ID('G', 'S', 'A'): return NMEA_GSA;
+        case NMEA_ID('G', 'S', 'V'): return NMEA_GSV;
+        case NMEA_ID('V', 'T', 'G'): return NMEA_VTG;
+        case NMEA_ID('G', 'L', 'L'): return NMEA_GLL;
+        default:                     return NMEA_UNKNOWN;
+    }
+}
+
+/**
+ * @brief Converts one hex digit of the transmitted checksum.
+ * @param c: Character after '*'.
+ * @return Value 0..15, or -1 if c is not a hex digit.
+ */
+static int8_t nmea_hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return (int8_t)(c - '0');
+    if (c >= 'A' && c <= 'F') return (int8_t)(c - 'A' + 10);
+    if (c >= 'a' && c <= 'f') return (int8_t)(c - 'a' + 10);
+    return -1;
+}
+
+/**
+ * @brief Abandons the current sentence as truncated, the claimed slot is kept for the next one.
+ */
+static void nmea_tokenizer_abort(void)
+{
+    tok_stats[tok_type].truncated++;
+    tok_state = TOK_HUNT;
+}
+
+/**
+ * @brief Verifies the checksum, then terminates the current sentence and hands it to the consumer.
+ */
+static void nmea_tokenizer_commit(void)
+{
+    tok_state = TOK_HUNT;
+    if (tok_rx_sum != tok_sum)
+    {
+        tok_stats[tok_type].checksum_failed++;   // slot is kept and reused for the next sentence
+        return;
+    }
+    tok_stats[tok_type].accepted++;
+
+    tok_slot->text[tok_len] = '\0';
+    tok_slot->len = tok_len;
+    tok_slot->fields = (tok_fields < NMEA_MAX_FIELDS) ? tok_fields : NMEA_MAX_FIELDS;
+    nmea_queue_publish();
+    tok_slot = NULL;
+}
+
+/**
+ * @brief Advances the state machine by one received character.
+ * @param c: Received character.
+ */
+static void nmea_tokenizer_char(char c)
+{
+    int8_t nibble;
+
+    // A '$' always starts a new sentence, an unfinished one is discarded
+    if (c == '$')
+    {
+        if (tok_state != TOK_HUNT)
+        {
+            tok_stats[tok_type].truncated++;
+        }
+        if (tok_slot == NULL)
+        {
+            tok_slot = nmea_queue_claim();   // NULL while the consumer is behind, counted as overflow
+        }
+        if (tok_slot == NULL)
+        {
+            tok_state = TOK_HUNT;
+            return;
+        }
+        tok_slot->text[0] = c;
+        tok_slot->rx_tick = (uint32_t)get_ticks();
+        tok_len = 1;
+        tok_count = 0;
+        tok_fields = 0;
+        tok_id = 0;
+        tok_type = NMEA_UNKNOWN;
+        tok_sum = 0;
+        tok_rx_sum = 0;
+        tok_state = TOK_TALKER;
+        return;
+    }
+
+    if (tok_state == TOK_HUNT)
+    {
+        return;
+    }
+
+    // Drop sentences that would run past the end of the slot
+    if (tok_len >= NMEA_SENTENCE_MAX - 1)
+    {
+        nmea_tokenizer_abort();
+        return;
+    }
+
+    switch (tok_state)
+    {
+        case TOK_TALKER:
+            if (c < 'A' || c > 'Z')
+            {
+                nmea_tokenizer_abort();
+                return;
+            }
+            tok_sum ^= (uint8_t)c;
+            if (++tok_count == NMEA_TALKER_LEN)
+            {
+                tok_count = 0;
+                tok_state = TOK_TYPE;
+            }
+            break;
+
+        case TOK_TYPE:
+            if (c == ',' && tok_count == NMEA_TYPE_LEN)
+            {
+                tok_sum ^= (uint8_t)c;
+                tok_type = nmea_type_lookup(tok_id);
+                tok_slot->type = (uint8_t)tok_type;
+                tok_slot->field_start[0] = 1;               // address field, right after '$'
+                tok_slot->field_start[1] = tok_len + 1;
+                tok_fields = 2;
+                tok_state = TOK_FIELDS;
+                break;
+            }
+            if (c < 'A' || c > 'Z' || tok_count == NMEA_TYPE_LEN)
+            {
+                nmea_tokenizer_abort();
+                return;
+            }
+            tok_sum ^= (uint8_t)c;
+            tok_id = (tok_id << 8) | (uint8_t)c;
+            tok_count++;
+            break;
+
+        case TOK_FIELDS:
+            if (c == '*')
+            {
+                if (tok_fields <= NMEA_MAX_FIELDS)
+                {
+                    tok_slot->field_start[tok_fields] = tok_len + 1;   // end marker for the last field
+                }
+                tok_count = 0;
+                tok_state = TOK_CHECKSUM;
+            }
+            else if (c == '\r' || c == '\n')
+            {
+                nmea_tokenizer_abort();   // line ended before the checksum
+                return;
+            }
+            else
+            {
+                tok_sum ^= (uint8_t)c;
+                if (c == ',')
+                {
+                    if (tok_fields <= NMEA_MAX_FIELDS)
+                    {
+                        tok_slot->field_start[tok_fields] = tok_len + 1;
+                    }
+                    tok_fields++;
+                }
+            }
+            break;
+
+        case TOK_CHECKSUM:
+            if (tok_count == 2)
+            {
+                if (c == '\r' || c == '\n')
+                {
+                    nmea_tokenizer_commit();
+                }
+                else
+                {
+                    nmea_tokenizer_abort();
+                }
+                return;
+            }
+            nibble = nmea_hex_value(c);
+            if (nibble < 0)
+            {
+                nmea_tokenizer_abort();
+                return;
+            }
+            tok_rx_sum = (uint8_t)((tok_rx_sum << 4) | (uint8_t)nibble);
+            tok_count++;
+            break;
+
+        default:
+            nmea_tokenizer_abort();
+            return;
+    }
+
+    tok_slot->text[tok_len++] = c;
+}
+
+/**
+ * @brief Resets the tokenizer to wait for the next '$'.
+ */
+void nmea_tokenizer_reset(void)
+{
+    tok_state = TOK_HUNT;
+}
+
+/**
+ * @brief Copies the link quality counters of one sentence type.
+ * @param type: Sentence type, NMEA_UNKNOWN covers sentences without a parser and
+ *              sentences cut off before their type was complete.
+ * @param stats: Destination for the counters.
+ */
+void nmea_tokenizer_stats(NMEATYPE type, NMEALINKSTATS *stats)
+{
+    if (type >= NMEA_TYPE_COUNT)
+    {
+        type = NMEA_UNKNOWN;
+    }
+    stats->accepted = tok_stats[type].accepted;
+    stats->checksum_failed = tok_stats[type].checksum_failed;
+    stats->truncated = tok_stats[type].truncated;
+}
+
+/**
+ * @brief Feeds a run of received bytes through the tokenizer.
+ * @param data: Received bytes.
+ * @param len: Number of bytes.
+ */
+void nmea_tokenizer_feed(const uint8_t *data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        nmea_tokenizer_char((char)data[i]);
+    }
+}
@@ -9,8 +9,9 @@
  * them for processing. Link below
  * @leveraged code We utilized ControllersTech's method
  * to convert latitude + longitude buffers to their
- * decimal representations. This is evident in the functions
- * GGA_analysis() and RMC_analysis().
+ * decimal representations. It has been replaced by the
+ * fixed-point decoding in nmea_fields.c and is kept only as
+ * the reference for NMEA_benchmark().
  * @link https://www.youtube.com/watch?v=tq_RoaPLahk&ab_channel=ControllersTech
  */
 
@@ -20,7 +21,6 @@
 #include "stdint.h"
 #include "stdlib.h"
 #include "string.h"
-#include "math.h"
 
 /**
  * User-defined libraries
@@ -28,14 +28,60 @@
 #include "fatfs.h"
 #include "fatfs_sd.h"
 #include "systick.h"
+#include "nmea_queue.h"
+#include "nmea_tokenizer.h"
+#include "nmea_fields.h"
+#include "gps_time.h"
 #include <parse_NMEA.h>
 
 /**
  * User defined Macros
+ * Field indices, field 0 is the address field ("GPGGA")
  */
+#define GGA_TIME	(1)
+#define GGA_LAT		(2)
+#define GGA_NS		(3)
+#define GGA_LON		(4)
+#define GGA_EW		(5)
 #define FIX_POS		(6)
+#define GGA_NUMSV	(7)
+#define GGA_HDOP	(8)
+#define GGA_ALT		(9)
+#define GGA_ALT_UNIT (10)
+
+#define RMC_TIME	(1)
 #define VALID_POS	(2)
 #define SPEED_POS	(7)
+#define RMC_COURSE	(8)
+#define RMC_DATE	(9)
+
+#define TIME_DIGITS	(3)		// hhmmss.sss kept as milliseconds
+
+#define GSA_MODE	(2)
+#define GSA_SV1		(3)
+#define GSA_PDOP	(15)
+#define GSA_HDOP	(16)
+#define GSA_VDOP	(17)
+
+#define GSV_NUM_MSG	(1)
+#define GSV_MSG		(2)
+#define GSV_IN_VIEW	(3)
+#define GSV_SAT1	(4)		// then elevation, azimuth, SNR, repeated every 4 fields
+
+#define VTG_COURSE	(1)
+#define VTG_SPEED_N	(5)
+#define VTG_SPEED_K	(7)
+#define VTG_MODE	(9)
+
+#define GLL_LAT		(1)
+#define GLL_LON		(3)
+#define GLL_TIME	(5)
+#define GLL_STATUS	(6)
+
+#define ALT_DIGITS		(2)		// metres -> centimetres
+#define SPEED_DIGITS	(3)		// knots -> milli-knots
+#define COURSE_DIGITS	(2)		// degrees -> centidegrees
+#define DOP_DIGITS		(2)		// DOP -> DOP * 100
 
 /**
  * File system and file variables
@@ -49,259 +95,224 @@ FIL fil3;
 UINT br3, bw3;
 
 /**
- * User defined variables
+ * GPS struct and instance
+ */
+GPSSTRUCT gnssTransfer;
+
+/**
+ * @brief Sentence handler signature, one entry per NMEATYPE.
+ */
+typedef void (*NMEAHANDLER)(NMEASLOT *slot);
+
+/**
+ * @brief Decodes a hhmmss.sss time field.
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index.
+ * @return Milliseconds since midnight, -1 if the field is too short or out of range.
+ */
+static int32_t nmea_time_of_day_ms(const NMEASLOT *slot, uint8_t idx)
+{
+    int32_t hour, min, frac;
+
+    if (nmea_field_len(slot, idx) < 6)
+    {
+        return -1;
+    }
+    hour = nmea_field_2digits(slot, idx, 0);
+    min = nmea_field_2digits(slot, idx, 2);
+    frac = nmea_field_fixed(slot, idx, TIME_DIGITS) % 100000;   // ssmmm, hhmm dropped
+    if (hour < 0 || hour > 23 || min < 0 || min > 59 || frac < 0)
+    {
+        return -1;
+    }
+    return (hour * 60 + min) * 60000 + frac;
+}
+
+// GGA and RMC re-anchor the time service before their logs are written, RMC also carries the date
+static void gga_handler(NMEASLOT *slot)
+{
+    if (nmea_field_int(slot, FIX_POS) != 0)
+    {
+        gps_time_set_tod(nmea_time_of_day_ms(slot, GGA_TIME), slot->rx_tick);
+    }
+    GGA_analysis(slot, &gnssTransfer.GGA);
+}
+
+static void rmc_handler(NMEASLOT *slot)
+{
+    if (nmea_field_char(slot, VALID_POS) == 'A' && nmea_field_len(slot, RMC_DATE) >= 6)
+    {
+        gps_time_set_date(nmea_field_2digits(slot, RMC_DATE, 4), nmea_field_2digits(slot, RMC_DATE, 2),
+                          nmea_field_2digits(slot, RMC_DATE, 0));
+        gps_time_set_tod(nmea_time_of_day_ms(slot, RMC_TIME), slot->rx_tick);
+    }
+    RMC_analysis(slot, &gnssTransfer.RMC);
+}
+
+static void gsa_handler(NMEASLOT *slot)
+{
+    GSA_analysis(slot, &gnssTransfer.GSA);
+}
+
+static void gsv_handler(NMEASLOT *slot)
+{
+    // The summary is refreshed once per second, when the last GSV message completes the table
+    if (GSV_analysis(slot, &gnssTransfer.GSV))
+    {
+        GPS_quality_update(&gnssTransfer);
+    }
+}
+
+static void vtg_handler(NMEASLOT *slot)
+{
+    VTG_analysis(slot, &gnssTransfer.VTG);
+}
+
+static void gll_handler(NMEASLOT *slot)
+{
+    GLL_analysis(slot, &gnssTransfer.GLL);
+}
+
+/**
+ * Dispatch table indexed by the sentence type the tokenizer found, NULL entries are skipped
+ */
+static const NMEAHANDLER nmea_handlers[NMEA_TYPE_COUNT] = {
+    [NMEA_GGA] = gga_handler,
+    [NMEA_RMC] = rmc_handler,
+    [NMEA_GSA] = gsa_handler,
+    [NMEA_GSV] = gsv_handler,
+    [NMEA_VTG] = vtg_handler,
+    [NMEA_GLL] = gll_handler,
+};
+
+/**
+ * @brief Appends "<label><field>\n" to an open log file, straight from the sentence text.
+ * @param fil: Open file.
+ * @param label: Text written before the field.
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index.
+ * @param bw: Byte count returned by f_write.
+ */
+static void log_field(FIL *fil, const char *label, const NMEASLOT *slot, uint8_t idx, UINT *bw)
+{
+    f_puts(label, fil);
+    f_write(fil, nmea_field(slot, idx), nmea_field_len(slot, idx), bw);
+}
+
+/**
+ * @brief Appends "UTC: <seconds>.<ms>\n" from the time service to an open log file.
+ * @param fil: Open file.
  */
-int index1 = 0;
+static void log_utc(FIL *fil)
+{
+    uint64_t utc_ms = gps_time_now_ms();
+
+    f_printf(fil, "UTC: %lu.%03u\n", (unsigned long)(utc_ms / 1000), (unsigned int)(utc_ms % 1000));
+}
 
 /**
- * @brief Checks the GPS fix status in the NMEA sentence.
- * @param input_buffer: NMEA sentence buffer.
- * @return The index of the GPS fix status in the buffer or -1 if not found.
+ * @brief Drains the received sentence queue, parsing and logging each sentence.
+ * @note Called from the main loop so FatFs work never runs in interrupt context.
  */
-int gps_fix_check(char *input_buffer) {
-  // This function checks if the input buffer contains a valid GPS fix.
-  // The buffer is expected to be a comma-separated string containing GPS data.
-
-  int comma_count = 0; // Initialize a counter for encountered commas.
-
-  // Loop through the first 60 characters of the buffer, searching for the expected number of commas.
-  for (int i = 0; i < 60; i++) {
-    if (input_buffer[i] == ',') {
-      comma_count++; // Increment the counter for each comma found.
-      if (comma_count == FIX_POS) { // Check if the expected number of commas is reached.
-        // FIX_POS is a predefined constant specifying the number of commas
-        // before the start of the GPS fix data (e.g., 6 for latitude,
-        // longitude, altitude, etc.).
-        return i + 1; // If found, return the index of the next character,
-        // signifying the start of the fix data.
-      }
+void NMEA_process(void)
+{
+    NMEASLOT *slot;
+
+    while ((slot = nmea_queue_peek()) != NULL)
+    {
+        if (slot->type < NMEA_TYPE_COUNT && nmea_handlers[slot->type] != NULL)
+        {
+            nmea_handlers[slot->type](slot);
+        }
+        nmea_queue_release();
     }
-  }
-  // No valid fix found within the first 60 characters or the expected comma count wasn't reached.
-  return -1; // Return -1 to indicate failure.
 }
 
 /**
  * @brief Parses and analyzes GGA NMEA sentence.
- * @param input_buffer: NMEA sentence buffer.
+ * @param slot: Tokenized GGA sentence.
  * @param gga: Pointer to the GGASTRUCT structure to store the parsed data.
  */
-void GGA_analysis(char *input_buffer, GGASTRUCT *gga)
+void GGA_analysis(const NMEASLOT *slot, GGASTRUCT *gga)
 {
-    // Initialize variables and buffers for extracted data.
-    int index1 = 0;
-    char time_buffer[12] = {0}; // Holds extracted time data.
-    char latitude_buffer[12] = {0}; // Holds extracted latitude data.
-    char longitude_buffer[12] = {0}; // Holds extracted longitude data.
-    char satellite_buffer[12] = {0}; // Holds extracted number of satellites.
-    char altitude_buffer[12] = {0}; // Holds extracted altitude data.
-
-    // Check if the input buffer contains a valid GPS fix.
-    index1 = gps_fix_check(input_buffer);
-    if (input_buffer[index1] == '0') {
+    // Check if the sentence contains a valid GPS fix.
+    if (nmea_field_int(slot, FIX_POS) == 0)
+    {
         // Fixbit indicates no valid fix, set GGA data accordingly and return.
         gga->fixbit_gga = 0;
         return;
-    } else {
-        // Valid fix found, set fixbit and reset index.
-        gga->fixbit_gga = 1;
-        index1 = 0;
     }
+    gga->fixbit_gga = 1;
 
-    // Extract time data from the sentence, starting at index 8 (after "$GPGGA,").
-    index1 = 8;
-    int i = 0;
-    for (; input_buffer[index1] != ','; time_buffer[i++] = input_buffer[index1++]);
-
-    // Convert time data to hours, minutes, and seconds with GMT adjustment.
-    gga->hour = ((time_buffer[0] - '0') * 10 + (time_buffer[1] - '0')) + (GMT/100) - 12;
-    gga->min = ((time_buffer[2] - '0') * 10 + (time_buffer[3] - '0')) + (GMT % 100);
-    gga->sec = (time_buffer[4] - '0') * 10 + (time_buffer[5] - '0');
-
-    // Extract latitude data (next field after comma).
-    index1++;
-    i = 0;
-    for (; input_buffer[index1] != ','; latitude_buffer[i++] = input_buffer[index1++]);
-
-    // Check for minimum buffer size to ensure proper conversion.
-    if (strlen(latitude_buffer) < 6) {
-        // Insufficient data, return error code.
-        return 2;
+    // UTC time data hhmmss.ss, local time comes from the time service.
+    if (nmea_field_len(slot, GGA_TIME) < 6 || nmea_field_len(slot, GGA_LAT) < 6)
+    {
+        // Insufficient data for a proper conversion.
+        return;
+    }
+    gga->hour = nmea_field_2digits(slot, GGA_TIME, 0);
+    gga->min = nmea_field_2digits(slot, GGA_TIME, 2);
+    gga->sec = nmea_field_2digits(slot, GGA_TIME, 4);
+
+    // Latitude and longitude from ddmm.mmmmm / dddmm.mmmmm to degrees * 1e7.
+    gga->latitude = nmea_field_coord(slot, GGA_LAT);
+    gga->NS = nmea_field_char(slot, GGA_NS);
+    gga->longitude = nmea_field_coord(slot, GGA_LON);
+    gga->EW = nmea_field_char(slot, GGA_EW);
+
+    // Number of satellites, HDOP, altitude and its unit.
+    gga->numofsat = nmea_field_int(slot, GGA_NUMSV);
+    gga->hdop = (uint16_t)nmea_field_fixed(slot, GGA_HDOP, DOP_DIGITS);
+    gga->altitude = nmea_field_fixed(slot, GGA_ALT, ALT_DIGITS);
+    gga->unit = nmea_field_char(slot, GGA_ALT_UNIT);
+
+    // Weak geometry or too few satellites, keep the values but do not log the position
+    if (gga->numofsat < GPS_QUALITY_MIN_SATS || gga->hdop > GPS_QUALITY_MAX_HDOP)
+    {
+        return;
     }
-
-    // Convert latitude buffer to a float value with decimal precision.
-    int num = atoi(latitude_buffer); // Convert string to integer (ignoring decimals).
-    int j = 0;
-    while (latitude_buffer[j] != '.') j++; // Find decimal point position.
-    j++; // Skip decimal point.
-    int declen = (strlen(latitude_buffer)) - j; // Calculate decimal part length.
-    int dec = atoi((char *)latitude_buffer + j); // Convert decimal part to integer.
-    float lat = (num / 100.0) + (dec / pow(10, (declen + 2))); // Combine integer and decimal parts.
-
-    // Store extracted latitude data in the GGA structure.
-    gga->latitude = lat;
-
-    // Extract North/South indicator (next character after comma) and store.
-    index1++;
-    int store_index_NS = index1;
-    gga->NS = input_buffer[index1];
-
-    // Extract longitude data (similar process as latitude).
-    index1++; // Skip comma after N/S indicator.
-    index1++; // Reach the first number in the longitude.
-    i = 0;
-    for (; input_buffer[index1] != ','; longitude_buffer[i++] = input_buffer[index1++]);
-
-    num = atoi(longitude_buffer); // Convert string to integer.
-    j = 0;
-    while (longitude_buffer[j] != '.') j++; // Find decimal point position.
-    j++; // Skip decimal point.
-    declen = (strlen(longitude_buffer)) - j; // Calculate decimal part length.
-    dec = atoi((char *)longitude_buffer + j); // Convert decimal part to integer.
-    lat = (num / 100.0) + (dec / pow(10, (declen + 2))); // Combine integer and decimal parts.
-
-    // Store extracted longitude data in the GGA structure.
-    gga->longitude = lat;
-
-    // Extract East/West indicator (next character after comma) and store.
-    index1++;
-    int store_index_EW = index1;
-    gga->EW = input_buffer[index1];
-
-    /**************************************************/
-    // Skip position fix and related commas.
-    index1++;   // ',' after E/W
-    index1++;   // Position fix
-    index1++;   // ',' after position fix;
-
-    // Number of satellites
-    index1++;  // Reach the first number in the satellites
-    i = 0;
-    for (; input_buffer[index1] != ','; satellite_buffer[i++] = input_buffer[index1++]);
-
-    // Convert and store the number of satellites in the GGA structure.
-    gga->numofsat = atoi(satellite_buffer);
-
-    /***************** Skip HDOP  *********************/
-    index1++;
-    while (input_buffer[index1] != ',') index1++;
-
-    // Extract altitude data (next field after HDOP).
-    index1++;
-    i = 0;
-    for (; input_buffer[index1] != ','; altitude_buffer[i++] = input_buffer[index1++]);
-
-    // Convert altitude buffer to a float value with decimal precision.
-    num = atoi(altitude_buffer);
-    j = 0;
-    while (altitude_buffer[j] != '.') j++;
-    j++;
-    declen = (strlen(altitude_buffer)) - j;
-    dec = atoi((char *)altitude_buffer + j);
-    lat = (num) + (dec / pow(10, (declen)));
-
-    // Store extracted altitude data in the GGA structure.
-    gga->altitude = lat;
-
-    // Extract altitude unit (next character after altitude data) and store.
-    index1++;
-    gga->unit = input_buffer[index1];
 
     // Mount the file system, open or create the file, and set file pointer to the end
     f_mount(&fs2, "", 0);
     f_open(&fil2, "GGA_DATA.txt", FA_OPEN_ALWAYS | FA_WRITE | FA_READ);
     f_lseek(&fil2, f_size(&fil2));
 
-    // Write timestamp data to the file
-    f_puts("Timestamp: ", &fil2);
-    f_write(&fil2, time_buffer, sizeof(time_buffer), &bw2);
+    // Write timestamp, position, satellites and altitude to the file
+    log_utc(&fil2);
+    log_field(&fil2, "Timestamp: ", slot, GGA_TIME, &bw2);
     f_puts("\n", &fil2);
-
-    // Write latitude data to the file
-    f_puts("Latitude: ", &fil2);
-    f_write(&fil2, latitude_buffer, sizeof(latitude_buffer), &bw2);
-    f_write(&fil2, input_buffer[store_index_NS], sizeof(char), &bw2);
+    log_field(&fil2, "Latitude: ", slot, GGA_LAT, &bw2);
+    f_write(&fil2, nmea_field(slot, GGA_NS), nmea_field_len(slot, GGA_NS), &bw2);
     f_puts("\n", &fil2);
-
-    // Write longitude data to the file
-    f_puts("Longitude: ", &fil2);
-    f_write(&fil2, longitude_buffer, sizeof(longitude_buffer), &bw2);
-    f_write(&fil2, input_buffer[store_index_EW], sizeof(char), &bw2);
+    log_field(&fil2, "Longitude: ", slot, GGA_LON, &bw2);
+    f_write(&fil2, nmea_field(slot, GGA_EW), nmea_field_len(slot, GGA_EW), &bw2);
     f_puts("\n", &fil2);
-
-    // Write number of satellites data to the file
-    f_puts("Number of satellites: ", &fil2);
-    f_write(&fil2, satellite_buffer, sizeof(satellite_buffer), &bw2);
+    log_field(&fil2, "Number of satellites: ", slot, GGA_NUMSV, &bw2);
     f_puts("\n", &fil2);
-
-    // Write altitude data to the file
-    f_puts("Altitude: ", &fil2);
-    f_write(&fil2, altitude_buffer, sizeof(altitude_buffer), &bw2);
+    log_field(&fil2, "Altitude: ", slot, GGA_ALT, &bw2);
     f_puts("\n", &fil2);
 
+    // Write the latest quality summary, taken from the GSA/GSV tables
+    f_printf(&fil2, "Quality: mode %u, used %u/%u, strong %u, mean SNR %u, PDOP %u.%02u, HDOP %u.%02u, VDOP %u.%02u\n",
+             gnssTransfer.quality.fix_mode, gnssTransfer.quality.sats_used, gnssTransfer.quality.sats_in_view,
+             gnssTransfer.quality.sats_strong, gnssTransfer.quality.mean_snr,
+             gnssTransfer.quality.pdop / 100, gnssTransfer.quality.pdop % 100,
+             gnssTransfer.quality.hdop / 100, gnssTransfer.quality.hdop % 100,
+             gnssTransfer.quality.vdop / 100, gnssTransfer.quality.vdop % 100);
+
     // Close the file
     f_close(&fil2);
 }
 
-
-/**
- * @brief Checks the validity status in the NMEA sentence.
- * @param input_buffer: NMEA sentence buffer.
- * @return The index of the validity status in the buffer or -1 if not found.
- */
-int valid_data_check(char *input_buffer)
-{
-	int comma_count = 0;
-	for(int i = 0; i < 60; i++)
-	{
-		if(input_buffer[i] == ',')
-		{
-			comma_count++;
-			if(comma_count == VALID_POS)
-			return i+1;
-		}
-	}
-	return -1;
-}
-
-/**
- * @brief Checks the speed data in the NMEA sentence.
- * @param input_buffer: NMEA sentence buffer.
- * @return The index of the speed data in the buffer or -1 if not found.
- */
-int speed_data_check(char *input_buffer)
-{
-	int comma_count = 0;
-		for(int i = 0; i < 60; i++)
-		{
-			if(input_buffer[i] == ',')
-			{
-				comma_count++;
-				if(comma_count == SPEED_POS)
-				return i+1;
-			}
-		}
-		return -1;
-}
-
 /**
  * @brief Parses and analyzes RMC NMEA sentence.
- * @param input_buffer: NMEA sentence buffer.
+ * @param slot: Tokenized RMC sentence.
  * @param rmc: Pointer to the RMCSTRUCT structure to store the parsed data.
  */
-void RMC_analysis(char *input_buffer, RMCSTRUCT *rmc)
+void RMC_analysis(const NMEASLOT *slot, RMCSTRUCT *rmc)
 {
-    // Initialize variables
-    index1 = 0;
-    char speed_buffer[12] = {0};
-    char course_buffer[12] = {0};
-    char date_buffer[12] = {0};
-
-    int i = 0;
-
     // Check the validity status in the NMEA sentence
-    index1 = valid_data_check(input_buffer);
-    if (input_buffer[index1] == 'A')
+    if (nmea_field_char(slot, VALID_POS) == 'A')
     {
         rmc->fixbit_rmc = 1;  // Valid data, set fixbit_rmc to 1
     }
@@ -311,87 +322,309 @@ void RMC_analysis(char *input_buffer, RMCSTRUCT *rmc)
         return;
     }
 
-    // Reset index1 to 0 and locate the speed data
-    index1 = 0;
-    index1 = speed_data_check(input_buffer);
+    // Speed and course, empty fields decode as 0
+    rmc->speed = nmea_field_fixed(slot, SPEED_POS, SPEED_DIGITS);
+    rmc->course = nmea_field_fixed(slot, RMC_COURSE, COURSE_DIGITS);
+
+    // Parse and store date components
+    if (nmea_field_len(slot, RMC_DATE) >= 6)
+    {
+        rmc->Day = nmea_field_2digits(slot, RMC_DATE, 0);
+        rmc->Mon = nmea_field_2digits(slot, RMC_DATE, 2);
+        rmc->Yr = nmea_field_2digits(slot, RMC_DATE, 4);
+    }
+
+    // Mount the file system, open or create the file, and set file pointer to the end
+    f_mount(&fs3, "", 0);
+    f_open(&fil3, "RMC_DATA.txt", FA_OPEN_ALWAYS | FA_WRITE | FA_READ);
+    f_lseek(&fil3, f_size(&fil3));
+
+    // Write speed, course and date data to the file
+    log_utc(&fil3);
+    log_field(&fil3, "Speed: ", slot, SPEED_POS, &bw3);
+    f_puts("\n", &fil3);
+    log_field(&fil3, "Course: ", slot, RMC_COURSE, &bw3);
+    f_puts("\n", &fil3);
+    log_field(&fil3, "Date: ", slot, RMC_DATE, &bw3);
+    f_puts("\n", &fil3);
 
-    // Parse and store speed data
-    i = 0;
-    for (; input_buffer[index1] != ','; speed_buffer[i++] = input_buffer[index1++]);
+    // Close the file
+    f_close(&fil3);
+}
 
-    if (strlen(speed_buffer) > 0)
+/**
+ * @brief Parses GSA NMEA sentence (fix mode, satellites used, DOP).
+ * @param slot: Tokenized GSA sentence.
+ * @param gsa: Pointer to the GSASTRUCT structure to store the parsed data.
+ */
+void GSA_analysis(const NMEASLOT *slot, GSASTRUCT *gsa)
+{
+    uint8_t used = 0;
+
+    gsa->mode = (uint8_t)nmea_field_int(slot, GSA_MODE);
+    for (uint8_t i = 0; i < GPS_MAX_USED; i++)
     {
-        // Convert and store speed data as a floating-point number
-        int16_t num = (atoi(speed_buffer));
-        int j = 0;
-        while (speed_buffer[j] != '.')
-            j++;
-        j++;
-        int declen = (strlen(speed_buffer)) - j;
-        int dec = atoi((char *)speed_buffer + j);
-        float lat = num + (dec / pow(10, (declen)));
-        rmc->speed = lat;
+        if (nmea_field_len(slot, GSA_SV1 + i) > 0)
+        {
+            gsa->used_prn[used++] = (uint8_t)nmea_field_int(slot, GSA_SV1 + i);
+        }
     }
-    else
+    gsa->num_used = used;
+    gsa->pdop = (uint16_t)nmea_field_fixed(slot, GSA_PDOP, DOP_DIGITS);
+    gsa->hdop = (uint16_t)nmea_field_fixed(slot, GSA_HDOP, DOP_DIGITS);
+    gsa->vdop = (uint16_t)nmea_field_fixed(slot, GSA_VDOP, DOP_DIGITS);
+}
+
+/**
+ * @brief Parses one GSV NMEA message into the satellite table.
+ * @note Message 1 of a group replaces the entries of the same talker, so GP and
+ *       GL groups from a multi-constellation receiver share the table.
+ * @param slot: Tokenized GSV sentence.
+ * @param gsv: Pointer to the GSVSTRUCT satellite table.
+ * @return 1 if this was the last message of its group, 0 otherwise.
+ */
+int GSV_analysis(const NMEASLOT *slot, GSVSTRUCT *gsv)
+{
+    int32_t num_msg = nmea_field_int(slot, GSV_NUM_MSG);
+    int32_t msg = nmea_field_int(slot, GSV_MSG);
+    uint8_t talker = (uint8_t)slot->text[2];
+    uint8_t kept = 0;
+
+    if (msg == 1)
     {
-        rmc->speed = 0;
+        // Drop the previous entries of this talker, keep the others in place
+        for (uint8_t i = 0; i < gsv->count; i++)
+        {
+            if (gsv->sat[i].talker != talker)
+            {
+                gsv->sat[kept++] = gsv->sat[i];
+            }
+        }
+        gsv->count = kept;
     }
+    gsv->in_view = (uint8_t)nmea_field_int(slot, GSV_IN_VIEW);
 
-    // Move to the next field (course data)
-    index1++;
-    i = 0;
-    for (; input_buffer[index1] != ','; course_buffer[i++] = input_buffer[index1++]);
+    // Up to four satellites per message, a trailing signal ID field is ignored
+    for (uint8_t f = GSV_SAT1; f + 3 < slot->fields && gsv->count < GPS_MAX_SATS; f += 4)
+    {
+        SATSTRUCT *sat;
+
+        if (nmea_field_len(slot, f) == 0)
+        {
+            continue;
+        }
+        sat = &gsv->sat[gsv->count++];
+        sat->prn = (uint8_t)nmea_field_int(slot, f);
+        sat->elevation = (int8_t)nmea_field_int(slot, f + 1);
+        sat->azimuth = (uint16_t)nmea_field_int(slot, f + 2);
+        sat->snr = (uint8_t)nmea_field_int(slot, f + 3);
+        sat->talker = talker;
+    }
+
+    return (msg == num_msg);
+}
+
+/**
+ * @brief Parses VTG NMEA sentence (course and speed over ground).
+ * @param slot: Tokenized VTG sentence.
+ * @param vtg: Pointer to the VTGSTRUCT structure to store the parsed data.
+ */
+void VTG_analysis(const NMEASLOT *slot, VTGSTRUCT *vtg)
+{
+    vtg->course = nmea_field_fixed(slot, VTG_COURSE, COURSE_DIGITS);
+    vtg->speed = nmea_field_fixed(slot, VTG_SPEED_N, SPEED_DIGITS);
+    vtg->speed_kph = nmea_field_fixed(slot, VTG_SPEED_K, SPEED_DIGITS);
+    vtg->mode = nmea_field_char(slot, VTG_MODE);
+}
 
-    if (strlen(course_buffer) > 0)
+/**
+ * @brief Parses GLL NMEA sentence (position and UTC time).
+ * @param slot: Tokenized GLL sentence.
+ * @param gll: Pointer to the GLLSTRUCT structure to store the parsed data.
+ */
+void GLL_analysis(const NMEASLOT *slot, GLLSTRUCT *gll)
+{
+    if (nmea_field_char(slot, GLL_STATUS) != 'A')
     {
-        // Convert and store course data as a floating-point number
-        int16_t num = (atoi(course_buffer));
-        int j = 0;
-        while (course_buffer[j] != '.')
-            j++;
-        j++;
-        int declen = (strlen(course_buffer)) - j;
-        int dec = atoi((char *)course_buffer + j);
-        float lat = num + (dec / pow(10, (declen)));
-        rmc->course = lat;
+        gll->fixbit_gll = 0;
+        return;
     }
-    else
+    gll->fixbit_gll = 1;
+    gll->latitude = nmea_field_coord(slot, GLL_LAT);
+    gll->longitude = nmea_field_coord(slot, GLL_LON);
+    gll->hour = nmea_field_2digits(slot, GLL_TIME, 0);
+    gll->min = nmea_field_2digits(slot, GLL_TIME, 2);
+    gll->sec = nmea_field_2digits(slot, GLL_TIME, 4);
+}
+
+/**
+ * @brief Summarises fix quality from the GSA and GSV tables, no sentence text is read.
+ * @param gps: Combined GPS data, gps->quality is updated.
+ */
+void GPS_quality_update(GPSSTRUCT *gps)
+{
+    GPSQUALITY *q = &gps->quality;
+    uint32_t snr_sum = 0;
+    uint8_t snr_count = 0;
+    uint8_t strong = 0;
+
+    for (uint8_t i = 0; i < gps->GSV.count; i++)
     {
-        rmc->course = 0;
+        const SATSTRUCT *sat = &gps->GSV.sat[i];
+
+        if (sat->snr >= GPS_QUALITY_STRONG_SNR)
+        {
+            strong++;
+        }
+        for (uint8_t u = 0; u < gps->GSA.num_used; u++)
+        {
+            if (gps->GSA.used_prn[u] == sat->prn)
+            {
+                snr_sum += sat->snr;
+                snr_count++;
+                break;
+            }
+        }
     }
 
-    // Move to the next field (date data)
-    index1++;
-    i = 0;
-    for (; input_buffer[index1] != ','; date_buffer[i++] = input_buffer[index1++]);
+    q->fix_mode = gps->GSA.mode;
+    q->sats_used = gps->GSA.num_used;
+    q->sats_in_view = gps->GSV.count;
+    q->sats_strong = strong;
+    q->mean_snr = snr_count ? (uint8_t)(snr_sum / snr_count) : 0;
+    q->pdop = gps->GSA.pdop;
+    q->hdop = gps->GSA.hdop;
+    q->vdop = gps->GSA.vdop;
+    q->good = (q->fix_mode >= 2) && (q->sats_used >= GPS_QUALITY_MIN_SATS) && (q->hdop <= GPS_QUALITY_MAX_HDOP);
+}
 
-    // Parse and store date components
-    rmc->Day = (date_buffer[0] - '0') * 10 + (date_buffer[1] - '0');
-    rmc->Mon = (date_buffer[2] - '0') * 10 + (date_buffer[3] - '0');
-    rmc->Yr = (date_buffer[4] - '0') * 10 + (date_buffer[5] - '0');
+#ifdef NMEA_BENCHMARK
+#include "math.h"
+#include "cycle_counter.h"
+#include "nmea_tokenizer.h"
 
-    // Mount the file system, open or create the file, and set file pointer to the end
-    f_mount(&fs3, "", 0);
-    f_open(&fil3, "RMC_DATA.txt", FA_OPEN_ALWAYS | FA_WRITE | FA_READ);
-    f_lseek(&fil3, f_size(&fil3));
+/**
+ * User defined Macros
+ */
+#define BENCH_ROUNDS	(100)
 
-    // Write speed data to the file
-    f_puts("Speed: ", &fil3);
-    f_write(&fil3, speed_buffer, sizeof(speed_buffer), &bw3);
-    f_puts("\n", &fil3);
+/**
+ * Sentences decoded by the benchmark, u-blox protocol specification examples
+ */
+static const struct {
+    NMEATYPE type;
+    const char *text;
+} bench_sentences[] = {
+    { NMEA_GGA, "$GPGGA,092725.00,4717.11399,N,00833.91590,E,1,08,1.01,499.6,M,48.0,M,,*5B" },
+    { NMEA_RMC, "$GPRMC,083559.00,A,4717.11437,N,00833.91522,E,0.004,77.52,091202,,,A*57" },
+};
 
-    // Write course data to the file
-    f_puts("Course: ", &fil3);
-    f_write(&fil3, course_buffer, sizeof(course_buffer), &bw3);
-    f_puts("\n", &fil3);
+/**
+ * @brief Splits a benchmark sentence into a private slot, the way the tokenizer fills a queue slot.
+ * @note The benchmark never touches the tokenizer or the queue, both belong to the USART2 interrupt.
+ * @param type: Sentence type.
+ * @param text: Sentence from '$' up to and including the checksum.
+ * @param slot: Slot to fill.
+ */
+static void bench_slot_fill(NMEATYPE type, const char *text, NMEASLOT *slot)
+{
+    uint8_t len = 0;
 
-    // Write date data to the file
-    f_puts("Date: ", &fil3);
-    f_write(&fil3, date_buffer, sizeof(date_buffer), &bw3);
-    f_puts("\n", &fil3);
+    slot->type = (uint8_t)type;
+    slot->fields = 1;
+    slot->field_start[0] = 1;
+    while (text[len] != '\0' && len < NMEA_SENTENCE_MAX - 1)
+    {
+        slot->text[len] = text[len];
+        len++;
+        if ((text[len - 1] == ',' || text[len - 1] == '*') && slot->fields < NMEA_MAX_FIELDS)
+        {
+            slot->field_start[slot->fields++] = len;
+        }
+    }
+    slot->text[len] = '\0';
+    slot->len = len;
+    slot->fields--;   // the last start only marks the end of the field before '*'
+}
 
-    // Close the file
-    f_close(&fil3);
+/**
+ * @brief Original decimal conversion: copy the field, atoi the integer and fraction parts, scale with pow().
+ * @param slot: Tokenized sentence.
+ * @param idx: Field index.
+ * @param shift: Extra decimal places, 2 turned ddmm.mmmm into dd.mmmmmm.
+ * @return Decoded value.
+ */
+static float legacy_decimal(const NMEASLOT *slot, uint8_t idx, int shift)
+{
+    char field_buffer[12] = {0};
+    int num, j, declen, dec;
+
+    memcpy(field_buffer, nmea_field(slot, idx), nmea_field_len(slot, idx));
+    num = atoi(field_buffer);
+    j = 0;
+    while (field_buffer[j] != '.' && field_buffer[j] != '\0') j++;
+    if (field_buffer[j] == '.') j++;
+    declen = (strlen(field_buffer)) - j;
+    dec = atoi((char *)field_buffer + j);
+    return (num / pow(10, shift)) + (dec / pow(10, (declen + shift)));
 }
 
+/**
+ * @brief Measures the cycles needed to decode the numeric GGA and RMC fields, old against new.
+ * @note Build with -DNMEA_BENCHMARK, call once after start-up and read the result in the debugger.
+ *       Only the decoding is timed, the SD card logging is the same for both.
+ * @param result: Average cycles per sentence.
+ */
+void NMEA_benchmark(NMEABENCH *result)
+{
+    const uint32_t count = sizeof(bench_sentences) / sizeof(bench_sentences[0]);
+    volatile float legacy_sink = 0;
+    volatile int32_t fixed_sink = 0;
+    uint32_t legacy = 0;
+    uint32_t fixed = 0;
+    uint32_t start;
+    NMEASLOT slot;
+
+    cycle_counter_init();
+    for (uint32_t n = 0; n < count; n++)
+    {
+        bench_slot_fill(bench_sentences[n].type, bench_sentences[n].text, &slot);
+
+        for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+        {
+            start = CYCLE_COUNTER();
+            if (slot.type == NMEA_GGA)
+            {
+                legacy_sink = legacy_decimal(&slot, GGA_LAT, 2);
+                legacy_sink = legacy_decimal(&slot, GGA_LON, 2);
+                legacy_sink = legacy_decimal(&slot, GGA_ALT, 0);
+            }
+            else if (slot.type == NMEA_RMC)
+            {
+                legacy_sink = legacy_decimal(&slot, SPEED_POS, 0);
+                legacy_sink = legacy_decimal(&slot, RMC_COURSE, 0);
+            }
+            legacy += CYCLE_COUNTER() - start;
+
+            start = CYCLE_COUNTER();
+            if (slot.type == NMEA_GGA)
+            {
+                fixed_sink = nmea_field_coord(&slot, GGA_LAT);
+                fixed_sink = nmea_field_coord(&slot, GGA_LON);
+                fixed_sink = nmea_field_fixed(&slot, GGA_ALT, ALT_DIGITS);
+            }
+            else if (slot.type == NMEA_RMC)
+            {
+                fixed_sink = nmea_field_fixed(&slot, SPEED_POS, SPEED_DIGITS);
+                fixed_sink = nmea_field_fixed(&slot, RMC_COURSE, COURSE_DIGITS);
+            }
+            fixed += CYCLE_COUNTER() - start;
+        }
+    }
 
+    (void)legacy_sink;
+    (void)fixed_sink;
+    result->legacy_cycles = legacy / (count * BENCH_ROUNDS);
+    result->fixed_cycles = fixed / (count * BENCH_ROUNDS);
+}
+#endif /* NMEA_BENCHMARK */
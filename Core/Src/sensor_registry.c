@@ -0,0 +1,183 @@
+/**
+ * @file sensor_registry.c
+ * @brief Registry of I2C3 sensor drivers and scheduler for their periodic burst reads.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note A sensor is a SENSORDRIVER table: identity, init sequence and one periodic
+ * burst read. sensor_poll() queues every burst that is due in the same pass, so the
+ * I2C3 engine runs them back to back, and hands finished bursts to their decoders on
+ * a later pass. Nothing here waits for the bus except sensor_init() at start-up.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * User-defined libraries
+ */
+#include "i2c.h"
+#include "systick.h"
+#include "sensor_registry.h"
+
+/**
+ * @brief Burst state, INFLIGHT and READY hand the buffer between the I2C interrupt and the main loop.
+ */
+typedef enum {
+    SENSOR_IDLE = 0,
+    SENSOR_INFLIGHT,
+    SENSOR_READY,
+} SENSORSTATE;
+
+/**
+ * @brief Registry entry.
+ */
+typedef struct {
+    const SENSORDRIVER *driver;
+    uint8_t data[SENSOR_READ_MAX];
+    uint32_t next_due;                /**< Tick of the next burst. */
+    volatile SENSORSTATE state;
+    SENSORSTATS stats;
+} SENSORSLOT;
+
+/**
+ * User defined variables
+ */
+static SENSORSLOT sensors[SENSOR_MAX];
+static uint8_t sensor_count = 0;
+
+/**
+ * @brief Completion of a periodic burst.
+ * @param status: I2C outcome.
+ * @param ctx: SENSORSLOT of the sensor.
+ */
+static void sensor_read_done(I2CSTATUS status, void *ctx)
+{
+    SENSORSLOT *slot = ctx;
+
+    if (status == I2C_OK)
+    {
+        slot->state = SENSOR_READY;
+    }
+    else
+    {
+        slot->stats.errors++;
+        slot->state = SENSOR_IDLE;
+    }
+}
+
+/**
+ * @brief Adds a driver to the registry.
+ * @param driver: Driver table, must stay valid.
+ * @return Handle, -1 if the registry is full or the burst is too long.
+ */
+int8_t sensor_register(const SENSORDRIVER *driver)
+{
+    if (sensor_count >= SENSOR_MAX || driver->read_len > SENSOR_READ_MAX)
+    {
+        return -1;
+    }
+    sensors[sensor_count].driver = driver;
+    sensors[sensor_count].state = SENSOR_IDLE;
+    return (int8_t)sensor_count++;
+}
+
+/**
+ * @brief Checks the identity register and writes the init sequence.
+ * @note Waits for the bus, for start-up only.
+ * @param handle: From sensor_register().
+ * @return 1 if the sensor is present and configured.
+ */
+uint8_t sensor_init(int8_t handle)
+{
+    SENSORSLOT *slot;
+    const SENSORDRIVER *drv;
+    uint8_t id = 0;
+
+    if (handle < 0 || handle >= sensor_count)
+    {
+        return 0;
+    }
+    slot = &sensors[handle];
+    drv = slot->driver;
+
+    MPU_Read(drv->address, drv->id_reg, &id, 1, NULL, NULL);
+    if (I2C_Wait() != I2C_OK || id != drv->id_value)
+    {
+        slot->stats.present = 0;
+        return 0;
+    }
+    for (uint8_t i = 0; i < drv->init_len; i++)
+    {
+        MPU_Write(drv->address, drv->init[i].reg, drv->init[i].value);
+        if (i % (I2C3_QUEUE_LEN / 2) == I2C3_QUEUE_LEN / 2 - 1)
+        {
+            I2C_Wait();   // long sequences must not overrun the transaction queue
+        }
+    }
+    slot->stats.present = (I2C_Wait() == I2C_OK);
+    slot->next_due = (uint32_t)get_ticks() + drv->period_ms;
+    return slot->stats.present;
+}
+
+/**
+ * @brief Delivers finished bursts and queues the ones that are due.
+ * @note Called from the main loop, never waits for the bus.
+ */
+void sensor_poll(void)
+{
+    uint32_t now = (uint32_t)get_ticks();
+
+    for (uint8_t i = 0; i < sensor_count; i++)
+    {
+        SENSORSLOT *slot = &sensors[i];
+        const SENSORDRIVER *drv = slot->driver;
+
+        if (slot->state == SENSOR_READY)
+        {
+            if (drv->on_data != NULL)
+            {
+                drv->on_data(slot->data, drv->read_len);
+            }
+            slot->stats.reads++;
+            slot->state = SENSOR_IDLE;
+        }
+
+        if (!slot->stats.present || drv->period_ms == 0 || (int32_t)(now - slot->next_due) < 0)
+        {
+            continue;
+        }
+        slot->next_due += drv->period_ms;
+        if ((int32_t)(now - slot->next_due) >= 0)
+        {
+            slot->next_due = now + drv->period_ms;   // fell behind, do not burst to catch up
+        }
+
+        if (slot->state != SENSOR_IDLE)
+        {
+            slot->stats.missed++;
+            continue;
+        }
+        slot->state = SENSOR_INFLIGHT;
+        if (!MPU_Read(drv->address, drv->read_reg, slot->data, drv->read_len, sensor_read_done, slot))
+        {
+            slot->stats.missed++;
+            slot->state = SENSOR_IDLE;
+        }
+    }
+}
+
+/**
+ * @brief Copies the counters of one sensor.
+ * @param handle: From sensor_register().
+ * @param stats: Destination.
+ */
+void sensor_stats(int8_t handle, SENSORSTATS *stats)
+{
+    if (handle >= 0 && handle < sensor_count)
+    {
+        *stats = sensors[handle].stats;
+    }
+}
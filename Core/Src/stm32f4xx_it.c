@@ -22,6 +22,8 @@
 #include "stm32f4xx_it.h"
 #include "systick.h"
 #include "uart.h"
+#include "i2c.h"
+#include "mpu6050.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 /* USER CODE END Includes */
@@ -223,4 +225,29 @@ void USART2_IRQHandler(void)
 {
 	usart2_call();
 }
+
+void DMA1_Stream5_IRQHandler(void)
+{
+	dma1_stream5_call();
+}
+
+void I2C3_EV_IRQHandler(void)
+{
+	i2c3_ev_call();
+}
+
+void I2C3_ER_IRQHandler(void)
+{
+	i2c3_er_call();
+}
+
+void DMA1_Stream2_IRQHandler(void)
+{
+	dma1_stream2_call();
+}
+
+void EXTI4_IRQHandler(void)
+{
+	mpu6050_drdy_call();
+}
 /* USER CODE END 1 */
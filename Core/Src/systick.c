@@ -29,6 +29,23 @@ void incr_ticks(void)
 	ticks++;
 }
 
+/**
+ * @brief Read the millisecond tick count.
+ * @note The 64 bit counter is read twice so an increment between the two halves is never seen torn.
+ * @return Milliseconds since SysTick was started.
+ */
+uint64_t get_ticks(void)
+{
+	uint64_t first, second;
+
+	do
+	{
+		first = ticks;
+		second = ticks;
+	} while (first != second);
+	return first;
+}
+
 /**
  * @brief Delay for the specified number of milliseconds using SysTick.
  * @param ms: Number of milliseconds to delay.
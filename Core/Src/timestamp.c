@@ -0,0 +1,39 @@
+/**
+ * @file timestamp.c
+ * @brief Free-running TIM2 microsecond counter used to timestamp sensor samples.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include "main.h"
+
+/**
+ * User-defined libraries
+ */
+#include "timestamp.h"
+
+/**
+ * @brief Starts TIM2 counting microseconds over its full 32-bit range.
+ * @note APB1 runs at half the core clock, so the timer kernel clock is twice PCLK1.
+ * @param None
+ */
+void timestamp_init(void)
+{
+	uint32_t timer_clk = HAL_RCC_GetPCLK1Freq();
+
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+	{
+		timer_clk *= 2;
+	}
+
+	RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+	TIM2->CR1 = 0;
+	TIM2->PSC = timer_clk / 1000000 - 1;   // 1 MHz
+	TIM2->ARR = 0xFFFFFFFF;
+	TIM2->CNT = 0;
+	TIM2->EGR = TIM_EGR_UG;                // load the prescaler now
+	TIM2->CR1 = TIM_CR1_CEN;
+}
@@ -12,36 +12,52 @@
 #include "stdint.h"
 #include "stdlib.h"
 #include "string.h"
-#include "math.h"
 
 /**
  * User-defined libraries
  */
-#include <parse_NMEA.h>
+#include "nmea_tokenizer.h"
+#include "gps_config.h"
 #include "uart.h"
 
 /**
- * User defined variables
+ * USART2 RX DMA circular buffer. DMA1 Stream5 Channel4 writes into it
+ * continuously, rx_dma_tail is the next byte not yet handed to the tokenizer.
  */
-volatile char GPRMC[100] = {0};
-volatile char GPVTG[100] = {0};
-volatile char GPGGA[100] = {0};
-volatile char GPGSA[100] = {0};
-volatile char GPGSV1[100] = {0};
-volatile char GPGSV2[100] = {0};
-volatile char GPGSV3[100] = {0};
-volatile char GPGLL[100] = {0};
-volatile char* NMEA[8] = {GPRMC, GPVTG, GPGGA, GPGSA, GPGSV1, GPGSV2, GPGSV3, GPGLL};
-volatile int32_t buf_count = 0;
-volatile uint32_t nmea_count = 0;
-volatile uint32_t uart_incr_ticks = 0;
-volatile uint8_t even_counter = 0;
-extern int16_t systick_count;
+static volatile uint8_t rx_dma_buf[UART2_RX_DMA_BUF_SIZE];
+static uint16_t rx_dma_tail = 0;
+volatile uint32_t uart2_rx_irq_count = 0;
 
 /**
- * GPS struct and instance
+ * USART2 TX ring buffer. The main loop appends at tx_head, the TXE interrupt
+ * sends from tx_tail, each index is written by one side only.
  */
-GPSSTRUCT gnssTransfer;
+static uint8_t tx_buf[UART2_TX_BUF_SIZE];
+static volatile uint32_t tx_head = 0;
+static volatile uint32_t tx_tail = 0;
+volatile uint32_t uart2_tx_dropped = 0;
+
+#if (UART2_TX_BUF_SIZE & (UART2_TX_BUF_SIZE - 1)) != 0
+#error "UART2_TX_BUF_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief Points DMA1 Stream5 at the start of the RX buffer and (re)enables it.
+ * @note Stream configuration and PAR are set once by Uart2Config(). The tokenizer
+ *       restarts too, a sentence cut by the restart would never complete.
+ * @retval None
+ */
+static void uart2_rx_dma_start(void)
+{
+	DMA1_Stream5->CR &= ~DMA_SxCR_EN;
+	while (DMA1_Stream5->CR & DMA_SxCR_EN);          // wait for the stream to stop
+	DMA1->HIFCR = DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5;
+	DMA1_Stream5->M0AR = (uint32_t)rx_dma_buf;
+	DMA1_Stream5->NDTR = UART2_RX_DMA_BUF_SIZE;
+	rx_dma_tail = 0;
+	nmea_tokenizer_reset();
+	DMA1_Stream5->CR |= DMA_SxCR_EN;
+}
 
 /**
   * @brief  This function is executed to initialize UART module, sets BAUD rate and enables the receiver and transmitter bit
@@ -62,27 +78,95 @@ void Uart2Config (void)
 	GPIOA->AFR[0] |= (7<<12); //  AF7 Alternate function for USART2 at Pin PA3
 
 	USART2->CR1 = 0x00;  // clear all
-	USART2->CR1 |= (1<<5) | (1<<7);
 
 
 	// Program the M bit in USART_CR1 to define the word length.
 	USART2->CR1 &= ~(1<<12);  // M =0; 8 bit word length
 
 	// Select the desired baud rate using the USART_BRR register.
-	USART2->BRR = 0x0341;   // Baud rate of 115200 AT 8MHz
+	Uart2SetBaud(UART2_DEFAULT_BAUD);
 
 	//Enable the Transmitter/Receiver by Setting the TE and RE bits in USART_CR1 Register
 	USART2->CR1 |= (1<<2); // RE=1,Enable the Receiver
 	USART2->CR1 |= (1<<3);  // TE=1,Enable Transmitter
 
-	//USART2->CR1 |= (1<<13); //UART ENABLE
+	// Receive through DMA1 Stream5 Channel4 into the circular buffer
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+	DMA1_Stream5->CR &= ~DMA_SxCR_EN;
+	while (DMA1_Stream5->CR & DMA_SxCR_EN);          // wait for the stream to stop
+	DMA1_Stream5->PAR = (uint32_t)&USART2->DR;
+	DMA1_Stream5->CR = DMA_SxCR_CHSEL_2              // Channel 4 = USART2_RX
+	                 | DMA_SxCR_MINC                 // increment memory, bytes in and out
+	                 | DMA_SxCR_CIRC                 // wrap around, never stops
+	                 | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+	uart2_rx_dma_start();
+
+	USART2->CR3 |= USART_CR3_DMAR;   // RX requests go to the DMA
+	USART2->CR1 |= USART_CR1_IDLEIE; // wake up once the line goes quiet after a burst
+	USART2->CR1 |= USART_CR1_UE;     // UART ENABLE, stays on from here
 
 	NVIC_SetPriority(USART2_IRQn, 2);
-	//NVIC_ClearPending(USART2_IRQn);
-	//NVIC_EnableIRQ(USART2_IRQn);
-	//NVIC_SetPriority(UART0_IRQn, 2); // could be 0, 1, 2, or 3 priority
-	//NVIC_ClearPendingIRQ(UART0_IRQn);
-	//NVIC_EnableIRQ(UART0_IRQn);
+	NVIC_SetPriority(DMA1_Stream5_IRQn, 2);
+	NVIC_ClearPendingIRQ(USART2_IRQn);
+	NVIC_ClearPendingIRQ(DMA1_Stream5_IRQn);
+	NVIC_EnableIRQ(USART2_IRQn);
+	NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+}
+
+/**
+ * @brief Programs USART2_BRR for a baud rate from the actual APB1 clock.
+ * @note With OVER8 = 0, BRR = PCLK1 / baud gives mantissa and 4 bit fraction in one go.
+ *       Any character still being sent is finished first.
+ * @param baud Baud rate in bits per second.
+ * @retval None
+ */
+void Uart2SetBaud (uint32_t baud)
+{
+	uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+
+	if (USART2->CR1 & USART_CR1_TE)
+	{
+		UART2_Flush();  // let queued characters leave at the old rate
+	}
+	USART2->BRR = (pclk1 + baud / 2) / baud;
+}
+
+/**
+ * @brief Queues bytes for transmission without waiting for the line.
+ * @note Main loop only, the TXE interrupt drains the queue. Bytes that do not fit are
+ *       dropped and counted in uart2_tx_dropped.
+ * @param data Pointer to the bytes to be sent.
+ * @param len Number of bytes.
+ * @retval Number of bytes accepted.
+ */
+uint16_t UART2_Write (const uint8_t *data, uint16_t len)
+{
+	uint32_t space = UART2_TX_BUF_SIZE - (tx_head - tx_tail);
+	uint16_t accepted = (len < space) ? len : (uint16_t)space;
+
+	for (uint16_t i = 0; i < accepted; i++)
+	{
+		tx_buf[(tx_head + i) & (UART2_TX_BUF_SIZE - 1)] = data[i];
+	}
+	__DMB();  // bytes must be in the buffer before the interrupt can see the new head
+	tx_head += accepted;
+	uart2_tx_dropped += len - accepted;
+
+	if (accepted)
+	{
+		USART2->CR1 |= USART_CR1_TXEIE;  // TXE fires right away if the data register is empty
+	}
+	return accepted;
+}
+
+/**
+ * @brief Waits until every queued byte has left the shift register.
+ * @retval None
+ */
+void UART2_Flush (void)
+{
+	while (tx_head != tx_tail);
+	while (!(USART2->SR & USART_SR_TC));
 }
 
 /**
@@ -92,8 +176,7 @@ void Uart2Config (void)
  */
 void UART2_SendChar (char c)
 {
-	USART2->DR = c; // load the data into DR register
-	while (!(USART2->SR & (1<<6))); //
+	UART2_Write((const uint8_t *)&c, 1);
 }
 
 /**
@@ -117,63 +200,123 @@ char UART2_GetChar (void)
  */
 void UART2_SendString (char *string)
 {
-	while (*string) UART2_SendChar (*string++);
+	UART2_Write((const uint8_t *)string, (uint16_t)strlen(string));
+}
+
+/**
+ * @brief Passes a run of received bytes to the NMEA tokenizer, and to the receiver
+ *        configuration engine while it is waiting for an acknowledgement.
+ * @param data Received bytes.
+ * @param len Number of bytes.
+ * @retval None
+ */
+static void uart2_rx_deliver(const uint8_t *data, uint16_t len)
+{
+    nmea_tokenizer_feed(data, len);
+    if (gps_config_listening)
+    {
+        gps_config_feed(data, len);
+    }
+}
+
+/**
+ * @brief Hands every byte the DMA wrote since the last call to the NMEA tokenizer.
+ * @note The write position is derived from NDTR, so this is safe to call from the
+ *       IDLE, half-transfer and transfer-complete interrupts alike.
+ * @retval None
+ */
+static void uart2_rx_dma_drain(void)
+{
+    uint16_t head = UART2_RX_DMA_BUF_SIZE - (uint16_t)DMA1_Stream5->NDTR;
+
+    if (head == UART2_RX_DMA_BUF_SIZE)
+    {
+        head = 0;
+    }
+
+    // At most two contiguous runs: up to the end of the buffer, then from its start
+    if (head < rx_dma_tail)
+    {
+        uart2_rx_deliver((const uint8_t *)&rx_dma_buf[rx_dma_tail], UART2_RX_DMA_BUF_SIZE - rx_dma_tail);
+        rx_dma_tail = 0;
+    }
+    if (head > rx_dma_tail)
+    {
+        uart2_rx_deliver((const uint8_t *)&rx_dma_buf[rx_dma_tail], head - rx_dma_tail);
+        rx_dma_tail = head;
+    }
 }
 
 /**
- * @brief Handles the USART2 interrupt, processes received NMEA sentences, and triggers analysis functions.
+ * @brief Sends a binary buffer, which may contain zero bytes, via UART.
+ * @param data Pointer to the bytes to be sent.
+ * @param len Number of bytes.
+ * @retval None
+ */
+void UART2_SendBuffer (const uint8_t *data, uint16_t len)
+{
+	UART2_Write(data, len);
+}
+
+/**
+ * @brief Handles the USART2 interrupt, fired when the GPS line goes idle after a burst
+ *        and whenever the transmit data register is free while the TX queue has data.
  * @note This function is invoked by the USART2 interrupt.
  * @retval None
  */
 void usart2_call(void)
 {
-    // Check if we are here because of RXNE interrupt
-    if (USART2->SR & USART_SR_RXNE) // If RX is not empty
+    // Check if we are here because of IDLE line interrupt
+    if (USART2->SR & USART_SR_IDLE)
+    {
+        (void)USART2->DR;                 // SR read followed by DR read clears IDLE
+        uart2_rx_irq_count++;
+        uart2_rx_dma_drain();
+    }
+
+    // Overrun can only happen if the DMA request was lost, clear it the same way
+    if (USART2->SR & USART_SR_ORE)
     {
-        // Store received character in the NMEA buffer
-        NMEA[nmea_count][buf_count] = (char)USART2->DR;
+        (void)USART2->DR;
+    }
 
-        // Check if the end of the NMEA sentence is reached
-        if (USART2->DR == '\n')
+    // Check if we are here because of TXE interrupt
+    if ((USART2->CR1 & USART_CR1_TXEIE) && (USART2->SR & USART_SR_TXE))
+    {
+        if (tx_tail != tx_head)
+        {
+            USART2->DR = tx_buf[tx_tail & (UART2_TX_BUF_SIZE - 1)];
+            tx_tail++;
+        }
+        else
         {
-            NMEA[nmea_count][buf_count] = '\0';          // Null-terminate the NMEA sentence
-            NMEA[nmea_count][buf_count - 1] = '\0';      // Remove the '\r' character
-            buf_count = 0;                               // Reset buffer count for the next sentence
-            nmea_count++;                                // Increment NMEA sentence count
-
-            // Check if all expected NMEA sentences are received
-            if (nmea_count == 8)
-            {
-                nmea_count = 0;                       // Reset NMEA sentence count
-                uart_incr_ticks++;                    // Increment UART ticks count
-                USART2->CR1 &= ~(1 << 13);           // Disable USART2 to stop receiving data
-                NVIC_DisableIRQ(USART2_IRQn);        // Disable USART2 interrupt
-
-                // Analyze and process the received sentences based on even/odd counters
-                if (even_counter % 2 == 0)
-                {
-                    GGA_analysis(NMEA[2], &gnssTransfer.GGA);
-                    even_counter = 1;
-                    systick_count = 0;                // Reset systick count
-                }
-                else
-                {
-                    RMC_analysis(NMEA[0], &gnssTransfer.RMC);
-                    even_counter = 0;
-                    systick_count = 0;                // Reset systick count
-                }
-                return;
-            }
+            USART2->CR1 &= ~USART_CR1_TXEIE;  // nothing left, stop until the next UART2_Write()
         }
-        buf_count++;
     }
+}
 
-    // Check if we are here because of TXEIE interrupt
-    if (USART1->SR & USART_SR_TXE) // If TX buffer is empty
+/**
+ * @brief Handles the DMA1 Stream5 interrupt, fired when the USART2 RX buffer is half or completely filled.
+ * @note This function is invoked by the DMA1 Stream5 interrupt.
+ * @retval None
+ */
+void dma1_stream5_call(void)
+{
+    if (DMA1->HISR & (DMA_HISR_HTIF5 | DMA_HISR_TCIF5))
     {
-        // Handle transmit completion here
+        DMA1->HIFCR = DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTCIF5;
+        uart2_rx_irq_count++;
+        uart2_rx_dma_drain();
     }
-}
-
-
 
+    // Transfer errors stop the stream, restart it from the top of the buffer so reception never stays off
+    if (DMA1->HISR & (DMA_HISR_TEIF5 | DMA_HISR_DMEIF5 | DMA_HISR_FEIF5))
+    {
+        DMA1->HIFCR = DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5;
+        if (!(DMA1_Stream5->CR & DMA_SxCR_EN))
+        {
+            uart2_rx_dma_drain();         // keep what arrived before the error
+            uart2_rx_dma_start();
+        }
+    }
+}
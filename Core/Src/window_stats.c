@@ -0,0 +1,179 @@
+/**
+ * @file window_stats.c
+ * @brief O(1) sliding-window sum, mean, min, max and variance of int16 samples.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Each push adds the new sample and retires the one leaving the window:
+ * the integer sum is exact, min and max come from the heads of two monotonic
+ * deques (every sample enters and leaves each deque once, so pushes are O(1)
+ * amortised), and the variance is a sliding Welford update. Float rounding in
+ * the Welford terms is cleared by an exact recomputation every WINSTATS_RESYNC
+ * windows, an exact integer pass over the window that stays O(1) amortised.
+ * @credit Monotonic deque window minimum: the "ascending minima" algorithm.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "window_stats.h"
+#include "dsp_kernels.h"
+
+/**
+ * User defined Macros
+ */
+#define WIN_MASK	(WINSTATS_MAX_LEN - 1)
+
+#if (WINSTATS_MAX_LEN & (WINSTATS_MAX_LEN - 1)) != 0
+#error "WINSTATS_MAX_LEN must be a power of two"
+#endif
+
+/**
+ * @brief Recomputes mean and m2 exactly from the samples in the window.
+ * @note n * m2 = n * sum(x^2) - sum(x)^2 is exact in 64-bit integers, the sum of
+ *       squares comes from the SIMD kernel over the (at most two) ring segments.
+ * @param w: Window.
+ */
+static void winstats_resync(WINSTATS *w)
+{
+    uint32_t first = (w->seq - w->count) & WIN_MASK;
+    uint32_t run = WINSTATS_MAX_LEN - first;
+    int64_t sumsq;
+
+    if (run >= w->count)
+    {
+        sumsq = dsp_sumsq_i16(&w->buf[first], w->count);
+    }
+    else
+    {
+        sumsq = dsp_sumsq_i16(&w->buf[first], run) + dsp_sumsq_i16(w->buf, w->count - run);
+    }
+    w->mean = (float)w->sum / w->count;
+    w->m2 = (float)((int64_t)w->count * sumsq - (int64_t)w->sum * w->sum) / w->count;
+}
+
+/**
+ * @brief Empties a window.
+ * @param w: Window.
+ * @param len: Window length, clamped to 1..WINSTATS_MAX_LEN.
+ */
+void winstats_init(WINSTATS *w, uint16_t len)
+{
+    if (len == 0)
+    {
+        len = 1;
+    }
+    if (len > WINSTATS_MAX_LEN)
+    {
+        len = WINSTATS_MAX_LEN;
+    }
+    w->len = len;
+    w->count = 0;
+    w->seq = 0;
+    w->sum = 0;
+    w->mean = 0.0f;
+    w->m2 = 0.0f;
+    w->min_head = w->min_tail = 0;
+    w->max_head = w->max_tail = 0;
+}
+
+/**
+ * @brief Adds a sample, retiring the oldest one once the window is full.
+ * @param w: Window.
+ * @param x: New sample.
+ */
+void winstats_push(WINSTATS *w, int16_t x)
+{
+    uint32_t s = w->seq;
+    float old_mean = w->mean;
+
+    if (w->count == w->len)
+    {
+        int16_t y = w->buf[(s - w->len) & WIN_MASK];
+
+        // Replace y by x: mean moves by (x - y) / n, m2 by (x - y)(x - new mean + y - old mean)
+        w->sum += x - y;
+        w->mean = old_mean + (float)(x - y) / w->len;
+        w->m2 += (float)(x - y) * ((x - w->mean) + (y - old_mean));
+
+        // Samples leaving the window leave the deques from the front
+        if (w->minq[w->min_head & WIN_MASK] == s - w->len)
+        {
+            w->min_head++;
+        }
+        if (w->maxq[w->max_head & WIN_MASK] == s - w->len)
+        {
+            w->max_head++;
+        }
+    }
+    else
+    {
+        w->count++;
+        w->sum += x;
+        w->mean = old_mean + (x - old_mean) / w->count;
+        w->m2 += (x - old_mean) * (x - w->mean);
+    }
+    w->buf[s & WIN_MASK] = x;
+
+    // Drop from the back every sample the new one dominates, they can never be the extreme again
+    while (w->min_tail != w->min_head && w->buf[w->minq[(w->min_tail - 1) & WIN_MASK] & WIN_MASK] >= x)
+    {
+        w->min_tail--;
+    }
+    w->minq[w->min_tail++ & WIN_MASK] = s;
+    while (w->max_tail != w->max_head && w->buf[w->maxq[(w->max_tail - 1) & WIN_MASK] & WIN_MASK] <= x)
+    {
+        w->max_tail--;
+    }
+    w->maxq[w->max_tail++ & WIN_MASK] = s;
+
+    w->seq = s + 1;
+    if (w->seq % ((uint32_t)w->len * WINSTATS_RESYNC) == 0)
+    {
+        winstats_resync(w);
+    }
+}
+
+/**
+ * @brief Smallest sample in the window.
+ * @param w: Window with at least one sample.
+ * @return Minimum.
+ */
+int16_t winstats_min(const WINSTATS *w)
+{
+    return w->buf[w->minq[w->min_head & WIN_MASK] & WIN_MASK];
+}
+
+/**
+ * @brief Largest sample in the window.
+ * @param w: Window with at least one sample.
+ * @return Maximum.
+ */
+int16_t winstats_max(const WINSTATS *w)
+{
+    return w->buf[w->maxq[w->max_head & WIN_MASK] & WIN_MASK];
+}
+
+/**
+ * @brief Mean of the window from the exact integer sum, truncated like the tumbling average was.
+ * @param w: Window with at least one sample.
+ * @return Mean.
+ */
+int16_t winstats_mean(const WINSTATS *w)
+{
+    return (int16_t)(w->sum / w->count);
+}
+
+/**
+ * @brief Population variance of the window.
+ * @param w: Window.
+ * @return Variance in squared counts, 0 for fewer than two samples.
+ */
+float winstats_variance(const WINSTATS *w)
+{
+    return (w->count > 1) ? w->m2 / w->count : 0.0f;
+}
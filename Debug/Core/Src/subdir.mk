@@ -5,46 +5,103 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Core/Src/attitude.c \
+../Core/Src/biquad.c \
+../Core/Src/blackbox.c \
+../Core/Src/cycle_counter.c \
+../Core/Src/dsp_kernels.c \
 ../Core/Src/events.c \
 ../Core/Src/fatfs_sd.c \
+../Core/Src/gps_config.c \
+../Core/Src/gps_time.c \
 ../Core/Src/i2c.c \
+../Core/Src/i2c_timing.c \
+../Core/Src/imu_convert.c \
+../Core/Src/imu_filter.c \
+../Core/Src/imu_ring.c \
 ../Core/Src/main.c \
+../Core/Src/maneuver.c \
+../Core/Src/mpu6050.c \
+../Core/Src/nmea_fields.c \
+../Core/Src/nmea_queue.c \
+../Core/Src/nmea_tokenizer.c \
 ../Core/Src/parse_NMEA.c \
+../Core/Src/sensor_registry.c \
 ../Core/Src/stm32f4xx_hal_msp.c \
 ../Core/Src/stm32f4xx_it.c \
 ../Core/Src/syscalls.c \
 ../Core/Src/sysmem.c \
 ../Core/Src/system_stm32f4xx.c \
 ../Core/Src/systick.c \
-../Core/Src/uart.c 
+../Core/Src/timestamp.c \
+../Core/Src/uart.c \
+../Core/Src/window_stats.c 
 
 OBJS += \
+./Core/Src/attitude.o \
+./Core/Src/biquad.o \
+./Core/Src/blackbox.o \
+./Core/Src/cycle_counter.o \
+./Core/Src/dsp_kernels.o \
 ./Core/Src/events.o \
 ./Core/Src/fatfs_sd.o \
+./Core/Src/gps_config.o \
+./Core/Src/gps_time.o \
 ./Core/Src/i2c.o \
+./Core/Src/i2c_timing.o \
+./Core/Src/imu_convert.o \
+./Core/Src/imu_filter.o \
+./Core/Src/imu_ring.o \
 ./Core/Src/main.o \
+./Core/Src/maneuver.o \
+./Core/Src/mpu6050.o \
+./Core/Src/nmea_fields.o \
+./Core/Src/nmea_queue.o \
+./Core/Src/nmea_tokenizer.o \
 ./Core/Src/parse_NMEA.o \
+./Core/Src/sensor_registry.o \
 ./Core/Src/stm32f4xx_hal_msp.o \
 ./Core/Src/stm32f4xx_it.o \
 ./Core/Src/syscalls.o \
 ./Core/Src/sysmem.o \
 ./Core/Src/system_stm32f4xx.o \
 ./Core/Src/systick.o \
-./Core/Src/uart.o 
+./Core/Src/timestamp.o \
+./Core/Src/uart.o \
+./Core/Src/window_stats.o 
 
 C_DEPS += \
+./Core/Src/attitude.d \
+./Core/Src/biquad.d \
+./Core/Src/blackbox.d \
+./Core/Src/cycle_counter.d \
+./Core/Src/dsp_kernels.d \
 ./Core/Src/events.d \
 ./Core/Src/fatfs_sd.d \
+./Core/Src/gps_config.d \
+./Core/Src/gps_time.d \
 ./Core/Src/i2c.d \
+./Core/Src/i2c_timing.d \
+./Core/Src/imu_convert.d \
+./Core/Src/imu_filter.d \
+./Core/Src/imu_ring.d \
 ./Core/Src/main.d \
+./Core/Src/maneuver.d \
+./Core/Src/mpu6050.d \
+./Core/Src/nmea_fields.d \
+./Core/Src/nmea_queue.d \
+./Core/Src/nmea_tokenizer.d \
 ./Core/Src/parse_NMEA.d \
+./Core/Src/sensor_registry.d \
 ./Core/Src/stm32f4xx_hal_msp.d \
 ./Core/Src/stm32f4xx_it.d \
 ./Core/Src/syscalls.d \
 ./Core/Src/sysmem.d \
 ./Core/Src/system_stm32f4xx.d \
 ./Core/Src/systick.d \
-./Core/Src/uart.d 
+./Core/Src/timestamp.d \
+./Core/Src/uart.d \
+./Core/Src/window_stats.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -54,7 +111,7 @@ Core/Src/%.o Core/Src/%.su Core/Src/%.cyclo: ../Core/Src/%.c Core/Src/subdir.mk
 clean: clean-Core-2f-Src
 
 clean-Core-2f-Src:
-	-$(RM) ./Core/Src/events.cyclo ./Core/Src/events.d ./Core/Src/events.o ./Core/Src/events.su ./Core/Src/fatfs_sd.cyclo ./Core/Src/fatfs_sd.d ./Core/Src/fatfs_sd.o ./Core/Src/fatfs_sd.su ./Core/Src/i2c.cyclo ./Core/Src/i2c.d ./Core/Src/i2c.o ./Core/Src/i2c.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/parse_NMEA.cyclo ./Core/Src/parse_NMEA.d ./Core/Src/parse_NMEA.o ./Core/Src/parse_NMEA.su ./Core/Src/stm32f4xx_hal_msp.cyclo ./Core/Src/stm32f4xx_hal_msp.d ./Core/Src/stm32f4xx_hal_msp.o ./Core/Src/stm32f4xx_hal_msp.su ./Core/Src/stm32f4xx_it.cyclo ./Core/Src/stm32f4xx_it.d ./Core/Src/stm32f4xx_it.o ./Core/Src/stm32f4xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32f4xx.cyclo ./Core/Src/system_stm32f4xx.d ./Core/Src/system_stm32f4xx.o ./Core/Src/system_stm32f4xx.su ./Core/Src/systick.cyclo ./Core/Src/systick.d ./Core/Src/systick.o ./Core/Src/systick.su ./Core/Src/uart.cyclo ./Core/Src/uart.d ./Core/Src/uart.o ./Core/Src/uart.su
+	-$(RM) ./Core/Src/attitude.cyclo ./Core/Src/attitude.d ./Core/Src/attitude.o ./Core/Src/attitude.su ./Core/Src/biquad.cyclo ./Core/Src/biquad.d ./Core/Src/biquad.o ./Core/Src/biquad.su ./Core/Src/blackbox.cyclo ./Core/Src/blackbox.d ./Core/Src/blackbox.o ./Core/Src/blackbox.su ./Core/Src/cycle_counter.cyclo ./Core/Src/cycle_counter.d ./Core/Src/cycle_counter.o ./Core/Src/cycle_counter.su ./Core/Src/dsp_kernels.cyclo ./Core/Src/dsp_kernels.d ./Core/Src/dsp_kernels.o ./Core/Src/dsp_kernels.su ./Core/Src/events.cyclo ./Core/Src/events.d ./Core/Src/events.o ./Core/Src/events.su ./Core/Src/fatfs_sd.cyclo ./Core/Src/fatfs_sd.d ./Core/Src/fatfs_sd.o ./Core/Src/fatfs_sd.su ./Core/Src/gps_config.cyclo ./Core/Src/gps_config.d ./Core/Src/gps_config.o ./Core/Src/gps_config.su ./Core/Src/gps_time.cyclo ./Core/Src/gps_time.d ./Core/Src/gps_time.o ./Core/Src/gps_time.su ./Core/Src/i2c.cyclo ./Core/Src/i2c.d ./Core/Src/i2c.o ./Core/Src/i2c.su ./Core/Src/i2c_timing.cyclo ./Core/Src/i2c_timing.d ./Core/Src/i2c_timing.o ./Core/Src/i2c_timing.su ./Core/Src/imu_convert.cyclo ./Core/Src/imu_convert.d ./Core/Src/imu_convert.o ./Core/Src/imu_convert.su ./Core/Src/imu_filter.cyclo ./Core/Src/imu_filter.d ./Core/Src/imu_filter.o ./Core/Src/imu_filter.su ./Core/Src/imu_ring.cyclo ./Core/Src/imu_ring.d ./Core/Src/imu_ring.o ./Core/Src/imu_ring.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/maneuver.cyclo ./Core/Src/maneuver.d ./Core/Src/maneuver.o ./Core/Src/maneuver.su ./Core/Src/mpu6050.cyclo ./Core/Src/mpu6050.d ./Core/Src/mpu6050.o ./Core/Src/mpu6050.su ./Core/Src/nmea_fields.cyclo ./Core/Src/nmea_fields.d ./Core/Src/nmea_fields.o ./Core/Src/nmea_fields.su ./Core/Src/nmea_queue.cyclo ./Core/Src/nmea_queue.d ./Core/Src/nmea_queue.o ./Core/Src/nmea_queue.su ./Core/Src/nmea_tokenizer.cyclo ./Core/Src/nmea_tokenizer.d ./Core/Src/nmea_tokenizer.o ./Core/Src/nmea_tokenizer.su ./Core/Src/parse_NMEA.cyclo ./Core/Src/parse_NMEA.d ./Core/Src/parse_NMEA.o ./Core/Src/parse_NMEA.su ./Core/Src/sensor_registry.cyclo ./Core/Src/sensor_registry.d ./Core/Src/sensor_registry.o ./Core/Src/sensor_registry.su ./Core/Src/stm32f4xx_hal_msp.cyclo ./Core/Src/stm32f4xx_hal_msp.d ./Core/Src/stm32f4xx_hal_msp.o ./Core/Src/stm32f4xx_hal_msp.su ./Core/Src/stm32f4xx_it.cyclo ./Core/Src/stm32f4xx_it.d ./Core/Src/stm32f4xx_it.o ./Core/Src/stm32f4xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32f4xx.cyclo ./Core/Src/system_stm32f4xx.d ./Core/Src/system_stm32f4xx.o ./Core/Src/system_stm32f4xx.su ./Core/Src/systick.cyclo ./Core/Src/systick.d ./Core/Src/systick.o ./Core/Src/systick.su ./Core/Src/timestamp.cyclo ./Core/Src/timestamp.d ./Core/Src/timestamp.o ./Core/Src/timestamp.su ./Core/Src/uart.cyclo ./Core/Src/uart.d ./Core/Src/uart.o ./Core/Src/uart.su ./Core/Src/window_stats.cyclo ./Core/Src/window_stats.d ./Core/Src/window_stats.o ./Core/Src/window_stats.su
 
 .PHONY: clean-Core-2f-Src
 
@@ -24,6 +24,7 @@ FATFS USERFatFS;    /* File system object for USER logical drive */
 FIL USERFile;       /* File object for USER */
 
 /* USER CODE BEGIN Variables */
+#include "gps_time.h"
 
 /* USER CODE END Variables */
 
@@ -45,7 +46,7 @@ void MX_FATFS_Init(void)
 DWORD get_fattime(void)
 {
   /* USER CODE BEGIN get_fattime */
-  return 0;
+  return gps_time_fattime();
   /* USER CODE END get_fattime */
 }
 
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""
+@file gen_filter_coeffs.py
+@brief Generates Core/Inc/filter_coeffs.h, the Q2.30 biquad coefficients of the IMU filter pipeline.
+@author Sonal Tamrakar, Prudhvi Kondapalli
+@date 12/16/2023
+@note Run from the repository root after changing a filter below: python3 Scripts/gen_filter_coeffs.py
+Butterworth sections from the RBJ audio EQ cookbook. After rounding, the numerator
+is adjusted so low-pass stages keep a DC gain of exactly 1 and high-pass stages
+exactly 0, so a still sensor neither drifts nor leaks gravity.
+"""
+
+import math
+import os
+
+Q = 30
+ONE = 1 << Q
+
+# Butterworth section Q factors for 2nd and 4th order
+BUTTER_Q = {2: [1 / math.sqrt(2)], 4: [0.54119610, 1.30656296]}
+
+# name, kind, order, corner Hz, sample rate Hz, comment
+FILTERS = [
+    ("filter_aa_1k", "low", 4, 25.0, 1000.0, "1 kHz anti-alias low-pass ahead of the /10 decimation to 100 Hz"),
+    ("filter_aa_100", "low", 4, 3.0, 100.0, "100 Hz anti-alias low-pass ahead of the /10 decimation to 10 Hz"),
+]
+
+
+def section(kind, f0, fs, q):
+    w0 = 2 * math.pi * f0 / fs
+    c, alpha = math.cos(w0), math.sin(w0) / (2 * q)
+    if kind == "low":
+        b = [(1 - c) / 2, 1 - c, (1 - c) / 2]
+    else:
+        b = [(1 + c) / 2, -(1 + c), (1 + c) / 2]
+    a0 = 1 + alpha
+    a = [-2 * c, 1 - alpha]
+    bq = [round(v / a0 * ONE) for v in b]
+    aq = [round(v / a0 * ONE) for v in a]
+    if kind == "low":
+        bq[1] = ONE + aq[0] + aq[1] - bq[0] - bq[2]
+    else:
+        bq[1] = -(bq[0] + bq[2])
+    for v in bq + aq:
+        assert -(1 << 31) <= v < (1 << 31), "coefficient out of Q2.30 range"
+    return bq + aq
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    path = os.path.join(root, "Core", "Inc", "filter_coeffs.h")
+    lines = [
+        "/**",
+        " * @file filter_coeffs.h",
+        " * @brief Q2.30 biquad coefficients of the IMU filter pipeline.",
+        " * @author Sonal Tamrakar, Prudhvi Kondapalli",
+        " * @date 12/16/2023",
+        " * @note Generated by Scripts/gen_filter_coeffs.py, edit the script and rerun it instead of this file.",
+        " */",
+        "",
+        "#ifndef INC_FILTER_COEFFS_H_",
+        "#define INC_FILTER_COEFFS_H_",
+        "",
+        "/**",
+        " * User-defined libraries",
+        " */",
+        '#include "biquad.h"',
+        "",
+    ]
+    for name, kind, order, f0, fs, comment in FILTERS:
+        lines.append("// %s, Butterworth order %d, %g Hz at %g Hz" % (comment, order, f0, fs))
+        lines.append("static const BIQUADCOEF %s[] = {" % name)
+        for q in BUTTER_Q[order]:
+            lines.append("    { %s }," % ", ".join("%d" % v for v in section(kind, f0, fs, q)))
+        lines.append("};")
+        lines.append("")
+    lines.append("#endif /* INC_FILTER_COEFFS_H_ */")
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,13 @@
+/**
+ * @file main.h
+ * @brief Host stand-in for Core/Inc/main.h, the modules under test only need the integer types.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef TESTS_STUBS_MAIN_H_
+#define TESTS_STUBS_MAIN_H_
+
+#include <stdint.h>
+
+#endif /* TESTS_STUBS_MAIN_H_ */
@@ -0,0 +1,67 @@
+/**
+ * @file stm32f4xx.h
+ * @brief Host stand-in for the CMSIS device header, with C models of the Cortex-M4 SIMD intrinsics.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note The models follow the ARMv7-M Architecture Reference Manual pseudocode, so a
+ * module built with -D__ARM_FEATURE_DSP=1 runs its SIMD path on the host. The GE
+ * flags set by __SSUB16 are kept in a variable that __SEL reads back.
+ */
+
+#ifndef TESTS_STUBS_STM32F4XX_H_
+#define TESTS_STUBS_STM32F4XX_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * User defined variables
+ */
+static uint32_t host_apsr_ge;   // GE[1:0], one bit per halfword lane
+
+/**
+ * User defined functions
+ */
+static inline uint32_t __UNALIGNED_UINT32_READ(const void *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));   // little-endian like the target
+    return v;
+}
+
+static inline int32_t lane_lo(uint32_t x) { return (int16_t)(x & 0xFFFF); }
+
+static inline int32_t lane_hi(uint32_t x) { return (int16_t)(x >> 16); }
+
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t acc)
+{
+    return acc + (uint32_t)(lane_lo(x) * lane_lo(y)) + (uint32_t)(lane_hi(x) * lane_hi(y));
+}
+
+static inline uint64_t __SMLALD(uint32_t x, uint32_t y, uint64_t acc)
+{
+    return acc + (uint64_t)((int64_t)lane_lo(x) * lane_lo(y) + (int64_t)lane_hi(x) * lane_hi(y));
+}
+
+static inline uint32_t __SSUB16(uint32_t x, uint32_t y)
+{
+    int32_t lo = lane_lo(x) - lane_lo(y);
+    int32_t hi = lane_hi(x) - lane_hi(y);
+
+    host_apsr_ge = (lo >= 0 ? 1u : 0u) | (hi >= 0 ? 2u : 0u);
+    return ((uint32_t)hi << 16) | ((uint32_t)lo & 0xFFFF);
+}
+
+static inline uint32_t __SEL(uint32_t x, uint32_t y)
+{
+    uint32_t lo = (host_apsr_ge & 1u) ? x : y;
+    uint32_t hi = (host_apsr_ge & 2u) ? x : y;
+
+    return (hi & 0xFFFF0000u) | (lo & 0xFFFF);
+}
+
+#endif /* TESTS_STUBS_STM32F4XX_H_ */
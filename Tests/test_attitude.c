@@ -0,0 +1,142 @@
+/**
+ * @file test_attitude.c
+ * @brief Host regression test of the attitude filter on a still sensor with a gyro offset.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note A still sensor at +-16 g / +-250 deg/s is fed at 1 kHz for 120 s with a few
+ * counts of noise. A 0.5 deg/s offset present from power-up must be measured and
+ * removed, one that appears after the start-up measurement must not tilt the
+ * estimate beyond a few degrees, and motion during start-up must delay the
+ * measurement instead of ending up in it.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * User-defined libraries
+ */
+#include "test_common.h"
+#include "imu_convert.h"
+#include "attitude.h"
+
+/**
+ * User defined Macros
+ */
+#define RATE_HZ			(1000)
+#define RUN_S			(120)
+#define LSB_PER_G		(2048)
+#define LSB_PER_DPS		(131)
+#define OFFSET_LSB		(66)		// 0.5 deg/s at 131 LSB/(deg/s)
+
+/**
+ * User defined variables
+ */
+static uint32_t seed = 12345;
+static uint32_t t_us;
+
+static int16_t noise(int16_t amplitude)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (int16_t)((int32_t)(seed % (2u * amplitude + 1)) - amplitude);
+}
+
+static void restart(void)
+{
+    IMUCAL cal = {
+        .accel_gain = { IMU_Q15_ONE, IMU_Q15_ONE, IMU_Q15_ONE },
+        .gyro_gain = { IMU_Q15_ONE, IMU_Q15_ONE, IMU_Q15_ONE },
+    };
+
+    imu_convert_init(3, 0);
+    imu_convert_calibrate(&cal);
+    attitude_init();
+    t_us = 0;
+}
+
+/**
+ * @brief Feeds still samples tilted by roll_deg about X, with gyro offsets and a rate on X.
+ * @return Largest tilt error seen after skip_s seconds, degrees.
+ */
+static float run(float seconds, float roll_deg, const int16_t offset[3], float rate_dps, float skip_s)
+{
+    IMUFRAME f;
+    VEHICLEMOTION m;
+    ATTITUDESTATUS st;
+    float roll = roll_deg * 3.14159265f / 180.0f;
+    float worst = 0.0f;
+    uint32_t n = (uint32_t)(seconds * RATE_HZ);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        t_us += 1000000 / RATE_HZ;
+        f.t_us = t_us;
+        f.ax = noise(4);
+        f.ay = (int16_t)lroundf(LSB_PER_G * sinf(roll)) + noise(4);
+        f.az = (int16_t)lroundf(LSB_PER_G * cosf(roll)) + noise(4);
+        f.gx = (int16_t)(offset[0] + lroundf(rate_dps * LSB_PER_DPS) + noise(3));
+        f.gy = (int16_t)(offset[1] + noise(3));
+        f.gz = (int16_t)(offset[2] + noise(3));
+        attitude_update(&f, &m);
+        if (i >= skip_s * RATE_HZ)
+        {
+            attitude_status(&st);
+            if (fabsf(st.tilt_deg - fabsf(roll_deg)) > worst)
+            {
+                worst = fabsf(st.tilt_deg - fabsf(roll_deg));
+            }
+        }
+    }
+    return worst;
+}
+
+int main(void)
+{
+    static const int16_t none[3] = { 0, 0, 0 };
+    static const int16_t offset_x[3] = { OFFSET_LSB, 0, 0 };
+    static const int16_t offset_xyz[3] = { OFFSET_LSB, -OFFSET_LSB, 2 * OFFSET_LSB };
+    ATTITUDESTATUS st;
+    float worst;
+
+    // Offset from power-up: measured in the first 2 s, no tilt builds up afterwards
+    restart();
+    worst = run(RUN_S, 0.0f, offset_x, 0.0f, 3.0f);
+    attitude_status(&st);
+    CHECK(st.gyro_valid);
+    CHECK(worst < 1.0f);
+    printf("  offset at power-up: worst tilt %.2f deg\n", worst);
+
+    // Same on every axis, sensor tilted 10 deg in its bracket
+    restart();
+    worst = run(RUN_S, 10.0f, offset_xyz, 0.0f, 3.0f);
+    CHECK(worst < 1.0f);
+    printf("  offset on all axes, 10 deg mount: worst tilt error %.2f deg\n", worst);
+
+    // Offset appearing after the start-up measurement, e.g. with temperature: bounded,
+    // and gone once the integral term has caught up
+    restart();
+    run(5.0f, 0.0f, none, 0.0f, 5.0f);
+    worst = run(RUN_S, 0.0f, offset_x, 0.0f, 0.0f);
+    CHECK(worst < 6.0f);
+    printf("  offset after start-up: worst tilt %.2f deg\n", worst);
+    worst = run(10.0f, 0.0f, offset_x, 0.0f, 0.0f);
+    CHECK(worst < 1.0f);
+    printf("  offset after start-up, settled: worst tilt %.2f deg\n", worst);
+
+    // Unit turning during start-up: no offset taken from that, measured once it is still
+    restart();
+    run(5.0f, 0.0f, none, 30.0f, 5.0f);
+    attitude_status(&st);
+    CHECK(!st.gyro_valid);
+    worst = run(RUN_S, 0.0f, offset_x, 0.0f, 3.0f);
+    attitude_status(&st);
+    CHECK(st.gyro_valid);
+    CHECK(worst < 1.0f);
+
+    return TEST_DONE("attitude");
+}
@@ -0,0 +1,42 @@
+/**
+ * @file test_common.h
+ * @brief Minimal check macros shared by the host tests.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ */
+
+#ifndef TESTS_TEST_COMMON_H_
+#define TESTS_TEST_COMMON_H_
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdio.h>
+
+/**
+ * User defined variables
+ */
+static int test_failures = 0;
+
+/**
+ * User defined Macros
+ */
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) do { \
+        long long va_ = (long long)(a), vb_ = (long long)(b); \
+        if (va_ != vb_) { \
+            printf("%s:%d: %s == %lld, expected %s == %lld\n", __FILE__, __LINE__, #a, va_, #b, vb_); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_DONE(name) \
+    (printf("%s: %s\n", (name), test_failures ? "FAILED" : "passed"), test_failures ? 1 : 0)
+
+#endif /* TESTS_TEST_COMMON_H_ */
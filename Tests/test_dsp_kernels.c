@@ -0,0 +1,119 @@
+/**
+ * @file test_dsp_kernels.c
+ * @brief Host test that every block kernel returns the same bits as its scalar reference.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Built twice by the Makefile: natively, where the kernels are the scalar
+ * fallbacks, and with -D__ARM_FEATURE_DSP=1, where the SIMD path runs on the
+ * intrinsic models of stubs/stm32f4xx.h. Every block length up to LEN_MAX is
+ * checked at both halfword alignments, on random and on full-scale data.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "test_common.h"
+#include "dsp_kernels.h"
+
+/**
+ * User defined Macros
+ */
+#define LEN_MAX		(300)
+
+/**
+ * User defined variables
+ */
+static int16_t buf_a[LEN_MAX + 1];
+static int16_t buf_b[LEN_MAX + 1];
+static uint32_t seed = 12345;
+
+static int16_t next_random(void)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (int16_t)seed;
+}
+
+static void check_all_lengths(const char *what)
+{
+    int before = test_failures;
+
+    for (uint32_t off = 0; off < 2; off++)
+    {
+        const int16_t *x = &buf_a[off];
+        const int16_t *y = &buf_b[off];
+
+        for (uint32_t n = 0; n + off <= LEN_MAX; n++)
+        {
+            CHECK_EQ(dsp_sum_i16(x, n), dsp_sum_i16_ref(x, n));
+            CHECK_EQ(dsp_sumsq_i16(x, n), dsp_sumsq_i16_ref(x, n));
+            CHECK_EQ(dsp_dot_i16(x, y, n), dsp_dot_i16_ref(x, y, n));
+            if (n > 0)
+            {
+                CHECK_EQ(dsp_min_i16(x, n), dsp_min_i16_ref(x, n));
+                CHECK_EQ(dsp_max_i16(x, n), dsp_max_i16_ref(x, n));
+            }
+            if (test_failures != before)
+            {
+                printf("  %s data, n = %lu, offset %lu\n", what, (unsigned long)n, (unsigned long)off);
+                return;
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    int16_t ramp[5] = { 3, -7, 12, -1, 5 };
+
+    // Hand-checked values, odd length so the scalar tail runs too
+    CHECK_EQ(dsp_sum_i16(ramp, 5), 12);
+    CHECK_EQ(dsp_sumsq_i16(ramp, 5), 9 + 49 + 144 + 1 + 25);
+    CHECK_EQ(dsp_dot_i16(ramp, ramp, 5), 228);
+    CHECK_EQ(dsp_min_i16(ramp, 5), -7);
+    CHECK_EQ(dsp_max_i16(ramp, 5), 12);
+
+    for (uint32_t i = 0; i <= LEN_MAX; i++)
+    {
+        buf_a[i] = next_random();
+        buf_b[i] = next_random();
+    }
+    check_all_lengths("random");
+
+    // Full scale: products of -32768 reach 2^30, pairs of them overflow 32 bits
+    for (uint32_t i = 0; i <= LEN_MAX; i++)
+    {
+        buf_a[i] = INT16_MIN;
+        buf_b[i] = INT16_MIN;
+    }
+    check_all_lengths("INT16_MIN");
+    CHECK_EQ(dsp_sumsq_i16(buf_a, LEN_MAX), (int64_t)LEN_MAX << 30);
+
+    for (uint32_t i = 0; i <= LEN_MAX; i++)
+    {
+        buf_a[i] = (i & 1) ? INT16_MAX : INT16_MIN;
+        buf_b[i] = (i & 2) ? INT16_MIN : INT16_MAX;
+    }
+    check_all_lengths("alternating");
+
+    // Extremes in either lane and at the scalar tail
+    for (uint32_t i = 0; i <= LEN_MAX; i++)
+    {
+        buf_a[i] = (int16_t)(i % 17);
+    }
+    buf_a[LEN_MAX - 1] = INT16_MIN;
+    buf_a[LEN_MAX - 2] = INT16_MAX;
+    check_all_lengths("single extreme");
+
+#ifdef __ARM_FEATURE_DSP
+    return TEST_DONE("dsp_kernels (SIMD model)");
+#else
+    return TEST_DONE("dsp_kernels (scalar)");
+#endif
+}
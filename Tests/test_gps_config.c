@@ -0,0 +1,264 @@
+/**
+ * @file test_gps_config.c
+ * @brief Host test of GPS_configure() against a simulated u-blox receiver.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note Stands in for SysTick and USART2. Every frame ubx_send() queues is parsed
+ * and checked like the receiver would, and the receiver answers by feeding its
+ * ACK-ACK / ACK-NAK straight into gps_config_feed() when both ends agree on the
+ * baud rate. SysTick advances on every read, so unanswered commands time out.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * User-defined libraries
+ */
+#include "test_common.h"
+#include "systick.h"
+#include "uart.h"
+#include "gps_config.h"
+
+/**
+ * User defined Macros
+ */
+#define CFG_CLASS		(0x06)
+#define CFG_PRT			(0x00)
+#define CFG_MSG			(0x01)
+#define CFG_RATE		(0x08)
+#define NMEA_CLASS		(0xF0)
+#define NO_NAK			(0xFF)
+
+/**
+ * @brief How the simulated receiver answers.
+ */
+typedef enum {
+    REPLY_ACK = 0,       /**< Plain ACK-ACK in one burst. */
+    REPLY_NOISY,         /**< NMEA text and an ACK for another command first, one byte per feed. */
+    REPLY_BAD_CHECKSUM,  /**< ACK-ACK with a corrupted checksum. */
+    REPLY_SILENT         /**< Never answers. */
+} REPLYMODE;
+
+/**
+ * User defined variables
+ */
+static uint64_t ticks;
+static uint32_t uart_baud;
+static uint32_t rx_baud;              // rate the receiver listens and talks at
+static REPLYMODE reply_mode;
+static uint8_t ignore_prt;            // receiver drops CFG-PRT, keeps its rate
+static uint8_t nak_msg_id;            // NMEA id whose CFG-MSG gets a NAK
+static uint8_t nmea_rate[8];          // last CFG-MSG rate per NMEA id
+static uint16_t meas_period;
+static uint32_t frames_sent;
+static uint32_t frames_bad;
+
+/**
+ * User defined functions
+ */
+uint64_t get_ticks(void)
+{
+    return ticks++;
+}
+
+void delay_ms_systick(int ms)
+{
+    ticks += (uint64_t)ms;
+}
+
+void Uart2SetBaud(uint32_t baud)
+{
+    uart_baud = baud;
+}
+
+static void reply(uint8_t ack, uint8_t cls, uint8_t id, uint8_t corrupt)
+{
+    uint8_t f[10] = { 0xB5, 0x62, 0x05, ack, 2, 0, cls, id, 0, 0 };
+
+    for (int i = 2; i < 8; i++)
+    {
+        f[8] += f[i];
+        f[9] += f[8];
+    }
+    f[9] ^= corrupt;
+    gps_config_feed(f, sizeof(f));
+}
+
+static void reply_noisy(uint8_t ack, uint8_t cls, uint8_t id)
+{
+    static const char nmea[] = "$GPGGA,,,,,,0,00,99.99,,,,,,*48\r\n";
+
+    for (size_t i = 0; i < sizeof(nmea) - 1; i++)
+    {
+        gps_config_feed((const uint8_t *)&nmea[i], 1);
+    }
+    reply(ack, cls, (uint8_t)(id + 1), 0);   // someone else's acknowledgement
+    reply(ack, cls, id, 0);
+}
+
+void UART2_SendBuffer(const uint8_t *data, uint16_t len)
+{
+    uint8_t ck_a = 0, ck_b = 0;
+    uint16_t plen;
+
+    frames_sent++;
+    if (len < 8 || data[0] != 0xB5 || data[1] != 0x62)
+    {
+        frames_bad++;
+        return;
+    }
+    plen = (uint16_t)(data[4] | data[5] << 8);
+    if (len != plen + 8)
+    {
+        frames_bad++;
+        return;
+    }
+    for (uint16_t i = 2; i < len - 2; i++)
+    {
+        ck_a += data[i];
+        ck_b += ck_a;
+    }
+    if (ck_a != data[len - 2] || ck_b != data[len - 1])
+    {
+        frames_bad++;
+        return;
+    }
+    if (uart_baud != rx_baud || data[2] != CFG_CLASS)
+    {
+        return;
+    }
+
+    const uint8_t *p = &data[6];
+    uint8_t ack = 1;
+
+    switch (data[3])
+    {
+        case CFG_PRT:
+            // the ACK leaves at the old rate and is lost to the new one, do not send it
+            if (!ignore_prt)
+            {
+                rx_baud = (uint32_t)(p[8] | p[9] << 8 | p[10] << 16 | (uint32_t)p[11] << 24);
+            }
+            return;
+        case CFG_MSG:
+            if (p[0] == NMEA_CLASS && p[1] == nak_msg_id)
+            {
+                ack = 0;
+            }
+            else if (p[0] == NMEA_CLASS && p[1] < sizeof(nmea_rate))
+            {
+                nmea_rate[p[1]] = p[2];
+            }
+            break;
+        case CFG_RATE:
+            meas_period = (uint16_t)(p[0] | p[1] << 8);
+            break;
+        default:
+            ack = 0;
+            break;
+    }
+
+    if (!gps_config_listening)
+    {
+        return;
+    }
+    switch (reply_mode)
+    {
+        case REPLY_ACK:          reply(ack, CFG_CLASS, data[3], 0); break;
+        case REPLY_NOISY:        reply_noisy(ack, CFG_CLASS, data[3]); break;
+        case REPLY_BAD_CHECKSUM: reply(ack, CFG_CLASS, data[3], 0x5A); break;
+        case REPLY_SILENT:       break;
+    }
+}
+
+static void receiver_reset(uint32_t baud, REPLYMODE mode)
+{
+    ticks = 0;
+    uart_baud = UART2_DEFAULT_BAUD;
+    rx_baud = baud;
+    reply_mode = mode;
+    ignore_prt = 0;
+    nak_msg_id = NO_NAK;
+    memset(nmea_rate, 0xEE, sizeof(nmea_rate));
+    meas_period = 0;
+    frames_sent = 0;
+    frames_bad = 0;
+}
+
+static const GPSCONFIG settings = {
+    .baud = 115200,
+    .meas_period_ms = 200,
+    .nmea_rate = {
+        [NMEA_GGA] = 1,
+        [NMEA_RMC] = 1,
+        [NMEA_GSA] = 1,
+        [NMEA_GSV] = 5,
+        [NMEA_VTG] = 0,
+        [NMEA_GLL] = 0,
+    },
+};
+
+int main(void)
+{
+    // Factory receiver at 9600: switched to 115200 and fully configured
+    receiver_reset(UART2_DEFAULT_BAUD, REPLY_ACK);
+    CHECK_EQ(GPS_configure(&settings), GPS_CFG_OK);
+    CHECK_EQ(uart_baud, 115200);
+    CHECK_EQ(rx_baud, 115200);
+    CHECK_EQ(nmea_rate[0x00], 1);   // GGA
+    CHECK_EQ(nmea_rate[0x01], 0);   // GLL
+    CHECK_EQ(nmea_rate[0x02], 1);   // GSA
+    CHECK_EQ(nmea_rate[0x03], 5);   // GSV
+    CHECK_EQ(nmea_rate[0x04], 1);   // RMC
+    CHECK_EQ(nmea_rate[0x05], 0);   // VTG
+    CHECK_EQ(meas_period, 200);
+    CHECK_EQ(frames_bad, 0);
+
+    // STM32 reset while the receiver kept 115200: found on the first probe
+    receiver_reset(115200, REPLY_ACK);
+    CHECK_EQ(GPS_configure(&settings), GPS_CFG_OK);
+    CHECK_EQ(uart_baud, 115200);
+    CHECK_EQ(meas_period, 200);
+
+    // Acknowledgement buried in NMEA output and another command's ACK, one byte at a time
+    receiver_reset(UART2_DEFAULT_BAUD, REPLY_NOISY);
+    CHECK_EQ(GPS_configure(&settings), GPS_CFG_OK);
+    CHECK_EQ(uart_baud, 115200);
+
+    // A rejected command is reported as such, the link stays at the new rate
+    receiver_reset(UART2_DEFAULT_BAUD, REPLY_ACK);
+    nak_msg_id = 0x03;
+    CHECK_EQ(GPS_configure(&settings), GPS_CFG_NAK);
+    CHECK_EQ(uart_baud, rx_baud);
+
+    // Receiver ignores CFG-PRT: USART2 goes back to the rate it still answers at
+    receiver_reset(UART2_DEFAULT_BAUD, REPLY_ACK);
+    ignore_prt = 1;
+    CHECK_EQ(GPS_configure(&settings), GPS_CFG_TIMEOUT);
+    CHECK_EQ(rx_baud, UART2_DEFAULT_BAUD);
+    CHECK_EQ(uart_baud, rx_baud);
+
+    // Same from 38400, the rate that answered first is the one restored
+    receiver_reset(38400, REPLY_ACK);
+    ignore_prt = 1;
+    CHECK_EQ(GPS_configure(&settings), GPS_CFG_TIMEOUT);
+    CHECK_EQ(uart_baud, 38400);
+
+    // Corrupted checksums are never taken as an ACK, every probe retries in full
+    receiver_reset(UART2_DEFAULT_BAUD, REPLY_BAD_CHECKSUM);
+    CHECK_EQ(GPS_configure(&settings), GPS_CFG_TIMEOUT);
+    CHECK_EQ(frames_sent, 3 * GPS_CFG_RETRIES);
+    CHECK_EQ(uart_baud, UART2_DEFAULT_BAUD);
+
+    // Nothing connected
+    receiver_reset(UART2_DEFAULT_BAUD, REPLY_SILENT);
+    CHECK_EQ(GPS_configure(&settings), GPS_CFG_TIMEOUT);
+    CHECK_EQ(uart_baud, UART2_DEFAULT_BAUD);
+    CHECK_EQ(frames_bad, 0);
+
+    return TEST_DONE("gps_config");
+}
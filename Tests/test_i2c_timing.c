@@ -0,0 +1,115 @@
+/**
+ * @file test_i2c_timing.c
+ * @brief Host test of I2C_Timing() against the RM0090 clock control formulas.
+ * @author Sonal Tamrakar, Prudhvi Kondapalli
+ * @date 12/16/2023
+ * @note For every mode and PCLK1 of 8, 16 and 42 MHz the expected CCR is the
+ * smallest one, within the mode's minimum, whose SCL period is not shorter than
+ * asked for. SCL low and high times are also checked against the I2C bus
+ * specification minimums.
+ */
+
+/**
+ * Default Libraries allowed to be used
+ */
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "test_common.h"
+#include "i2c.h"
+
+/**
+ * User defined Macros
+ */
+#define CCR_MASK		(0x0FFF)
+
+/**
+ * @brief One mode of the clock control register, as described in RM0090 27.6.8.
+ */
+typedef struct {
+    const char *name;
+    uint32_t speed;        /**< SCL asked for. */
+    I2CDUTY duty;
+    uint32_t high;         /**< Thigh in CCR * Tpclk1 units. */
+    uint32_t low;          /**< Tlow in CCR * Tpclk1 units. */
+    uint32_t ccr_min;
+    uint32_t rise_ns;      /**< Maximum SCL rise time of the mode, for TRISE. */
+    uint32_t high_min_ns;  /**< I2C bus specification minimums. */
+    uint32_t low_min_ns;
+    uint16_t flags;        /**< F/S and DUTY bits expected in CCR. */
+} MODE;
+
+static const MODE modes[] = {
+    { "standard 100 kHz", 100000, I2C_DUTY_2, 1, 1, 4, 1000, 4000, 4700, 0 },
+    { "fast 400 kHz duty 2", 400000, I2C_DUTY_2, 1, 2, 1, 300, 600, 1300, CCR_FS_BIT },
+    { "fast 400 kHz duty 16/9", 400000, I2C_DUTY_16_9, 9, 16, 1, 300, 600, 1300, CCR_FS_BIT | CCR_DUTY_BIT },
+};
+
+static const uint32_t pclk1_hz[] = { 8000000, 16000000, 42000000 };
+
+static void check_mode(const MODE *m, uint32_t pclk1)
+{
+    I2CTIMING t = {0};
+    uint32_t ccr = m->ccr_min;
+    uint32_t mhz = pclk1 / 1000000;
+
+    // SCL = PCLK1 / ((Thigh + Tlow) * CCR), never above the speed asked for
+    while ((uint64_t)pclk1 > (uint64_t)m->speed * (m->high + m->low) * ccr)
+    {
+        ccr++;
+    }
+
+    CHECK(I2C_Timing(pclk1, m->speed, m->duty, &t));
+    CHECK_EQ(t.freq, mhz);
+    CHECK_EQ(t.ccr & CCR_MASK, ccr);
+    CHECK_EQ(t.ccr & ~CCR_MASK, m->flags);
+    CHECK_EQ(t.trise, m->rise_ns * mhz / 1000 + 1);     // TRISE = Trise(max) / Tpclk1 + 1
+    CHECK_EQ(t.scl_hz, pclk1 / ((m->high + m->low) * ccr));
+    CHECK(t.scl_hz <= m->speed);
+    CHECK((uint64_t)m->high * ccr * 1000000000u / pclk1 >= m->high_min_ns);
+    CHECK((uint64_t)m->low * ccr * 1000000000u / pclk1 >= m->low_min_ns);
+    if (test_failures)
+    {
+        printf("  in %s at PCLK1 %lu Hz\n", m->name, (unsigned long)pclk1);
+    }
+}
+
+int main(void)
+{
+    I2CTIMING t = {0};
+
+    for (unsigned i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        for (unsigned k = 0; k < sizeof(pclk1_hz) / sizeof(pclk1_hz[0]); k++)
+        {
+            check_mode(&modes[i], pclk1_hz[k]);
+        }
+    }
+
+    // RM0090 worked values: 100 kHz from 8 MHz is CCR 0x28, TRISE 9; 400 kHz from 42 MHz, duty 2 is CCR 35
+    CHECK(I2C_Timing(8000000, 100000, I2C_DUTY_2, &t));
+    CHECK_EQ(t.ccr, 0x28);
+    CHECK_EQ(t.trise, 9);
+    CHECK_EQ(t.scl_hz, 100000);
+    CHECK(I2C_Timing(42000000, 400000, I2C_DUTY_2, &t));
+    CHECK_EQ(t.ccr, CCR_FS_BIT | 35);
+    CHECK_EQ(t.trise, 13);
+    CHECK_EQ(t.scl_hz, 400000);
+
+    // This board: PCLK1 = 8 MHz, duty 2 cannot reach 400 kHz and rounds down
+    CHECK(I2C_Timing(8000000, I2C3_SPEED_HZ, I2C3_FAST_DUTY, &t));
+    CHECK_EQ(t.ccr, CCR_FS_BIT | 7);
+    CHECK_EQ(t.scl_hz, 380952);
+
+    // Outside what the peripheral allows
+    CHECK(!I2C_Timing(1000000, 100000, I2C_DUTY_2, &t));     // below 2 MHz
+    CHECK(!I2C_Timing(51000000, 100000, I2C_DUTY_2, &t));    // above 50 MHz
+    CHECK(!I2C_Timing(3000000, 400000, I2C_DUTY_2, &t));     // fast mode needs 4 MHz
+    CHECK(!I2C_Timing(16000000, 0, I2C_DUTY_2, &t));
+    CHECK(!I2C_Timing(16000000, 1000000, I2C_DUTY_2, &t));   // fast mode plus is not supported
+    CHECK(!I2C_Timing(42000000, 5000, I2C_DUTY_2, &t));      // CCR above 12 bits
+
+    return TEST_DONE("i2c_timing");
+}